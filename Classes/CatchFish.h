@@ -8,6 +8,7 @@
 struct CatchFish;
 #ifndef CC_TARGET_PLATFORM
 struct Peer;
+struct Service;
 #else
 struct Panel_Player;
 #endif
@@ -28,8 +29,9 @@ inline xx::List<cocos2d::Touch*> cc_touchs;
 struct Peer;
 #endif
 #include "xx_pos.h"
+#include "xx_spacegrid.h"
+#include "xx_dict.h"
 #include "xx_random.h"
-#include "chipmunk.h"
 #include "PKG_class.h"
 
 
@@ -40,6 +42,9 @@ struct Peer;
 // 是否显示物理碰撞检测线
 #define DRAW_PHYSICS_POLYGON 0
 
+// 是否每帧输出场景状态 hash( 分别记录 重构前后 / client & server 的日志, 逐行比对即可定位首个结果不一致的帧 )
+#define LOG_SCENE_HASH 0
+
 static constexpr xx::Pos designSize = xx::Pos{ 1280, 720 };
 static constexpr xx::Pos designSize_2 = xx::Pos{ designSize.x / 2, designSize.y / 2 };
 static constexpr float designWidthRatio = designSize.x / (designSize.x + designSize.y);
@@ -78,14 +83,42 @@ struct CatchFish {
 	// 所有玩家的强存储
 	xx::List<PKG::CatchFish::Player_s> players;
 
-	// 游戏场景实例
-	PKG::CatchFish::Scene_s scene;
+	// 玩家 id 索引( 与 players 同步增删 )
+	xx::Dict<int, PKG::CatchFish::Player*> playerById;
 
+#ifndef CC_TARGET_PLATFORM
+	// 玩家 token 索引( 与 players 同步增删. 断线重连时定位玩家 )
+	xx::Dict<std::string, PKG::CatchFish::Player_w> playerByToken;
+#endif
 
 #ifndef CC_TARGET_PLATFORM
+	// 所有场景( 下标即 scene->roomId ). 按需创建, 玩家走光后保留待复用. 只 Update 有玩家的场景
+	xx::List<PKG::CatchFish::Scene_s> scenes;
+
+	// 场景数上限. 达到后不再创建, 此时找不到空位的玩家无法进入
+	int maxScenes = 10000;
+
+	// 所属服务( 由 Service 填充 ). 场景经由此访问 calc 连接等
+	Service* service = nullptr;
+
 	// 初始化( 加载配置文件, .... )
 	int Init(std::string const& cfgName) noexcept;
+
+	// 初始化( 使用已 LoadConfig 的配置. 配置只读, 可被多个 loop 线程的 CatchFish 共享 )
+	int Init(PKG::CatchFish::Configs::Config_s const& cfg) noexcept;
+
+	// 从文件加载配置并 InitCascade. 出问题返回非 0
+	static int LoadConfig(std::string const& cfgName, PKG::CatchFish::Configs::Config_s& cfg) noexcept;
+
+	// 新建一个场景并放入 scenes. 失败返回空
+	PKG::CatchFish::Scene_s CreateScene() noexcept;
+
+	// 为新玩家挑选场景并取出一个空位: 优先凑满已有玩家且空位最少的场景, 其次复用空场景, 最后新建. 失败返回 nullptr
+	PKG::CatchFish::Scene* Match(PKG::CatchFish::Sits& sit) noexcept;
 #else
+	// 游戏场景实例
+	PKG::CatchFish::Scene_s scene;
+
 	// server info( Init 时填充 )
 	std::string serverIp;
 	int serverPort = 0;
@@ -96,6 +129,15 @@ struct CatchFish {
 	// logic. 每帧调用一次. 返回非0 表示退出
 	int Update() noexcept;
 
+	// 将玩家放入 players 并建立索引( 须先填充 id, token )
+	void AddPlayer(PKG::CatchFish::Player_s const& p) noexcept;
+
+	// 清空 players 及索引
+	void ClearPlayers() noexcept;
+
+	// 用 id 定位玩家. 找不到返回 nullptr
+	PKG::CatchFish::Player* FindPlayer(int const& playerId) const noexcept;
+
 	// 清掉某玩家( 复制传入以避免引用到容器内的地址造成无法正常删除 )
 	void Cleanup(PKG::CatchFish::Player_s p) noexcept;
 
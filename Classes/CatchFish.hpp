@@ -14,7 +14,14 @@ inline int CatchFish::Update() noexcept {
 #ifdef CC_TARGET_PLATFORM
 	return dialer->Update();
 #else
-	return scene->Update();
+	for (auto&& s : scenes) {
+		// 没玩家的场景不推进( 再有玩家进入时 从停下的地方继续, 新玩家会收到完整同步 )
+		if (!s->players->len) continue;
+		if (int r = s->Update()) {
+			xx::CoutTN("scene update failed. roomId = ", s->roomId, " r = ", r);
+		}
+	}
+	return 0;
 #endif
 }
 
@@ -39,7 +46,7 @@ inline int ReadFile(const char* fn, xx::BBuffer& bb)
 	return 0;
 }
 
-inline int CatchFish::Init(std::string const& cfgName) noexcept {
+inline int CatchFish::LoadConfig(std::string const& cfgName, PKG::CatchFish::Configs::Config_s& cfg) noexcept {
 	// 从文件加载 cfg. 出问题返回非 0
 	{
 		xx::BBuffer bb;
@@ -47,33 +54,89 @@ inline int CatchFish::Init(std::string const& cfgName) noexcept {
 		if (int r = bb.ReadRoot(cfg)) return r;
 	}
 	// 初始化派生类的东西
-	if (int r = cfg->InitCascade()) return r;
+	return cfg->InitCascade();
+}
+
+inline int CatchFish::Init(std::string const& cfgName) noexcept {
+	PKG::CatchFish::Configs::Config_s cfg;
+	if (int r = LoadConfig(cfgName, cfg)) return r;
+	return Init(cfg);
+}
+
+inline int CatchFish::Init(PKG::CatchFish::Configs::Config_s const& cfg) noexcept {
+	assert(cfg && !scenes.len);
+	this->cfg = cfg;
+
+	// 先建一个场景, 确保配置可用
+	if (!CreateScene()) return -1;
+	return 0;
+}
+
+inline PKG::CatchFish::Scene_s CatchFish::CreateScene() noexcept {
+	if ((int)scenes.len >= maxScenes) return nullptr;
 
 	// 场景初始化
-	xx::MakeTo(scene);
+	auto&& scene = xx::Make<PKG::CatchFish::Scene>();
+	scene->roomId = (int)scenes.len;
 	xx::MakeTo(scene->borns);
 	xx::MakeTo(scene->fishs);
 	xx::MakeTo(scene->freeSits);
 	xx::MakeTo(scene->items);
 	xx::MakeTo(scene->players);
-	xx::MakeTo(scene->rnd, 123);				// todo: 时间 seed ?
+	xx::MakeTo(scene->rnd, 123 + scene->roomId);	// todo: 时间 seed ?
 	xx::MakeTo(scene->frameEvents);
 	xx::MakeTo(scene->frameEvents->events);
 	xx::MakeTo(scene->hitChecks);
 	xx::MakeTo(scene->hitChecks->hits);
 	scene->cfg = &*cfg;
 	scene->catchFish = this;
-	
+
 	// 关卡初始化
-	int r = cfg->stageBufs[0].ReadRoot(scene->stage);
-	assert(!r);
-	scene->stage->InitCascade(&*scene);
+	if (int r = scene->InitStages()) {
+		xx::CoutTN("scene InitStages failed. r = ", r);
+		return nullptr;
+	}
+	scene->SwitchStage(0);
 
 	// 空位初始化
 	scene->freeSits->Add(PKG::CatchFish::Sits::LeftTop
 		, PKG::CatchFish::Sits::RightTop
 		, PKG::CatchFish::Sits::RightBottom
 		, PKG::CatchFish::Sits::LeftBottom);
+
+	scenes.Add(scene);
+	return scene;
+}
+
+inline PKG::CatchFish::Scene* CatchFish::Match(PKG::CatchFish::Sits& sit) noexcept {
+	PKG::CatchFish::Scene* best = nullptr;
+	PKG::CatchFish::Scene* empty = nullptr;
+	for (auto&& s : scenes) {
+		auto&& n = s->freeSits->len;
+		if (!n) continue;
+		if (s->players->len) {
+			if (!best || n < best->freeSits->len) {
+				best = &*s;
+				if (n == 1) break;
+			}
+		}
+		else if (!empty) {
+			empty = &*s;
+		}
+	}
+	if (!best) {
+		best = empty;
+	}
+	if (!best) {
+		auto&& s = CreateScene();
+		if (!s) return nullptr;
+		best = &*s;
+	}
+	auto&& r = best->freeSits->TryPop(sit);
+	assert(r);
+	(void)r;
+	return best;
+}
 #else
 inline int CatchFish::Init(std::string const& ip, int const& port, std::string const& cfgName) noexcept {
 	// 暂存 ip, port
@@ -135,9 +198,38 @@ inline int CatchFish::Init(std::string const& ip, int const& port, std::string c
 
 	// 初始化拨号器
 	xx::MakeTo(::dialer);
-#endif
 	return 0;
 }
+#endif
+
+inline void CatchFish::AddPlayer(PKG::CatchFish::Player_s const& p) noexcept {
+	assert(p);
+	auto&& r = playerById.Add(p->id, &*p);
+	assert(r.success);
+	(void)r;
+#ifndef CC_TARGET_PLATFORM
+	auto&& r2 = playerByToken.Add(p->token, PKG::CatchFish::Player_w(p));
+	assert(r2.success);
+	(void)r2;
+	if (service && service->routes) {
+		service->routes->Add(p->token, service->loopIndex);
+	}
+#endif
+	players.Add(p);
+}
+
+inline void CatchFish::ClearPlayers() noexcept {
+	players.Clear();
+	playerById.Clear();
+#ifndef CC_TARGET_PLATFORM
+	playerByToken.Clear();
+#endif
+}
+
+inline PKG::CatchFish::Player* CatchFish::FindPlayer(int const& playerId) const noexcept {
+	auto&& idx = playerById.Find(playerId);
+	return idx == -1 ? nullptr : playerById.ValueAt(idx);
+}
 
 inline void CatchFish::Cleanup(PKG::CatchFish::Player_s p) noexcept {
 	assert(p);
@@ -153,6 +245,13 @@ inline void CatchFish::Cleanup(PKG::CatchFish::Player_s p) noexcept {
 	// 从玩家总容器移除
 	assert(players.Find(p) != -1);
 	players.Remove(p);
+	playerById.Remove(p->id);
+#ifndef CC_TARGET_PLATFORM
+	playerByToken.Remove(p->token);
+	if (service && service->routes) {
+		service->routes->Remove(p->token, service->loopIndex);
+	}
+#endif
 
 	// 从玩家所在场景移除
 	auto && ps = *p->scene->players;
@@ -33,7 +33,7 @@ inline int Dialer::HandleFirstPackage() noexcept {
 
 		// store players
 		for (auto&& p : *es->players) {
-			::catchFish->players.Add(p);
+			::catchFish->AddPlayer(p);
 		}
 
 		// store scene
@@ -79,11 +79,9 @@ inline int Dialer::HandlePackagesOrUpdateScene() noexcept {
 			auto&& fe = xx::As<PKG::CatchFish_Client::FrameEvents>(recvs.front());
 			// 重置超时判断条件( 暂定 5 秒 )
 			timeoutFrameNumber = fe->frameNumber + 60 * 5;
-			// 如果本地帧编号慢于 server 则追帧
+			// 如果本地帧编号慢于 server 则追帧( 追帧过程中不绘制, 追完刷新一次 )
 			if (fe->frameNumber > ::catchFish->scene->frameNumber) {
-				while (fe->frameNumber > ::catchFish->scene->frameNumber) {
-					if (int r = ::catchFish->scene->Update()) return r;
-				}
+				if (int r = ::catchFish->scene->FastForward(fe->frameNumber)) return r;
 				needUpdateScene = false;
 			}
 			// 依次处理事件集合
@@ -146,7 +144,7 @@ inline void Dialer::Reset() noexcept {
 	peer.reset();
 	recvs.clear();
 	player.reset();
-	::catchFish->players.Clear();
+	::catchFish->ClearPlayers();
 	::catchFish->scene.reset();
 }
 
@@ -193,7 +191,7 @@ inline int Dialer::Handle(PKG::CatchFish::Events::Enter_s o) noexcept {
 	}
 
 	// 将玩家放入相应容器
-	catchFish->players.Add(player);
+	catchFish->AddPlayer(player);
 	catchFish->scene->players->Add(player);
 
 	// 进一步初始化
@@ -221,44 +219,32 @@ inline int Dialer::Handle(PKG::CatchFish::Events::NoMoney_s o) noexcept {
 }
 
 inline int Dialer::Handle(PKG::CatchFish::Events::Refund_s o) noexcept {
-	// 目标玩家应该被定位到
-	assert(catchFish->players.Exists([&](PKG::CatchFish::Player_s const& p) { return p->id == o->playerId; }));
-
-	// 定位到目标玩家
-	for (auto&& p : catchFish->players) {
-		if (p->id == o->playerId) {
-			// 退款
-			p->coin += o->coin;
-			break;
-		}
+	// 定位到目标玩家( 应该被定位到 )
+	auto&& p = catchFish->FindPlayer(o->playerId);
+	assert(p);
+	if (p) {
+		// 退款
+		p->coin += o->coin;
 	}
 	return 0;
 }
 
 inline int Dialer::Handle(PKG::CatchFish::Events::FishDead_s o) noexcept {
-	// 目标玩家应该被定位到
-	assert(catchFish->players.Exists([&](PKG::CatchFish::Player_s const& p) { return p->id == o->playerId; }));
-
-	// 定位到目标玩家
-	for (auto&& p : catchFish->players) {
-		if (p->id == o->playerId) {
-			// 鱼在不在都要加钱( 有可能收到包的时候 目标鱼 已经消失 )
-			p->coin += o->coin;
-
-			// todo: 判断如果 o->fishDeads 有数据，或者 打死鱼的是 特殊子弹（比如炸弹），还要进一步处理
-
-			// 试定位到目标鱼
-			auto&& fs = *player->scene->fishs;
-			for (auto&& f : fs) {
-				if (f->id == o->fishId) {
-					// todo: 特效
-					// 删鱼
-					fs[fs.len - 1]->indexAtContainer = f->indexAtContainer;
-					fs.SwapRemoveAt(f->indexAtContainer);
-					break;
-				}
-			}
-			break;
+	// 定位到目标玩家( 应该被定位到 )
+	auto&& p = catchFish->FindPlayer(o->playerId);
+	assert(p);
+	if (p) {
+		// 鱼在不在都要加钱( 有可能收到包的时候 目标鱼 已经消失 )
+		p->coin += o->coin;
+
+		// todo: 判断如果 o->fishDeads 有数据，或者 打死鱼的是 特殊子弹（比如炸弹），还要进一步处理
+
+		// 试定位到目标鱼
+		auto&& scene = *catchFish->scene;
+		if (auto&& f = scene.FindFish(o->fishId)) {
+			// todo: 特效
+			// 删鱼
+			scene.RemoveFishAt(f->indexAtContainer);
 		}
 	}
 	return 0;
@@ -273,7 +259,7 @@ inline int Dialer::Handle(PKG::CatchFish::Events::PushFish_s o) noexcept {
 	assert(o->playerId == 0);
 
 	// 确保服务器下发 id 不重复
-	assert(o->born && o->born->fish && !catchFish->scene->fishs->Exists([&](PKG::CatchFish::Fish_s const& f) { return f->id == o->born->fish->id; }));
+	assert(o->born && o->born->fish && !catchFish->scene->FindFish(o->born->fish->id));
 
 	// 如果太晚收到预约包就断线重连
 	if (o->born->beginFrameNumber <= catchFish->scene->frameNumber) return -2;
@@ -304,24 +290,20 @@ inline int Dialer::Handle(PKG::CatchFish::Events::CloseAutoFire_s o) noexcept {
 }
 
 inline int Dialer::Handle(PKG::CatchFish::Events::Fire_s o) noexcept {
-	// 目标玩家应该被定位到
-	assert(catchFish->players.Exists([&](PKG::CatchFish::Player_s const& p) { return p->id == o->playerId; }));
-
 	// 如果是自己发射的就忽略( 本地已经处理过了 )
 	if (o->playerId == player->id) return 0;
 
-	// 定位到目标玩家
-	for (auto&& p : catchFish->players) {
-		if (p->id == o->playerId) {
-			// 定位到目标炮台
-			for (auto&& c : *p->cannons) {
-				if (c->id == o->cannonId) {
-					// 发射
-					(void)c->Fire(*o);
-					break;
-				}
+	// 定位到目标玩家( 应该被定位到 )
+	auto&& p = catchFish->FindPlayer(o->playerId);
+	assert(p);
+	if (p) {
+		// 定位到目标炮台
+		for (auto&& c : *p->cannons) {
+			if (c->id == o->cannonId) {
+				// 发射
+				(void)c->Fire(*o);
+				break;
 			}
-			break;
 		}
 	}
 	return 0;
@@ -332,24 +314,20 @@ inline int Dialer::Handle(PKG::CatchFish::Events::CannonSwitch_s o) noexcept {
 }
 
 inline int Dialer::Handle(PKG::CatchFish::Events::CannonCoinChange_s o) noexcept {
-	// 目标玩家应该被定位到
-	assert(catchFish->players.Exists([&](PKG::CatchFish::Player_s const& p) { return p->id == o->playerId; }));
-
 	// 如果是自己的就忽略
 	if (o->playerId == player->id) return 0;
 
-	// 定位到目标玩家
-	for (auto&& p : catchFish->players) {
-		if (p->id == o->playerId) {
-			// 定位到目标炮台
-			for (auto&& c : *p->cannons) {
-				if (c->id == o->cannonId) {
-					c->coin = o->coin;
-					c->SetText_Coin();
-					break;
-				}
+	// 定位到目标玩家( 应该被定位到 )
+	auto&& p = catchFish->FindPlayer(o->playerId);
+	assert(p);
+	if (p) {
+		// 定位到目标炮台
+		for (auto&& c : *p->cannons) {
+			if (c->id == o->cannonId) {
+				c->coin = o->coin;
+				c->SetText_Coin();
+				break;
 			}
-			break;
 		}
 	}
 	return 0;
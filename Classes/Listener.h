@@ -1,13 +1,64 @@
-﻿struct Service {
+﻿// 多 loop 共享的玩家路由: token -> 玩家所在 loop 下标. 可于任意 loop 线程访问
+// 断线重连落到别的 loop 时, 凭此找到玩家所在 loop, 经 UvGroup::Dispatch 将玩家摘下并迁到新连接所在 loop
+struct PlayerRoutes {
+	xx::UvGroup& group;
+
+	// 下标为 loop 下标. 各元素只由该 loop 线程读写( Service 构造 / 析构时填充 / 清除 )
+	std::vector<Service*> services;
+
+	// 玩家 id 于各 loop 间唯一( 迁移后 id 不变 )
+	std::atomic<int> playerAutoId{ 0 };
+
+	PlayerRoutes(xx::UvGroup& group) : group(group), services(group.Size()) {}
+	PlayerRoutes(PlayerRoutes const&) = delete;
+	PlayerRoutes& operator=(PlayerRoutes const&) = delete;
+
+	void Add(std::string const& token, int const& loopIndex) noexcept;
+
+	// 只移除指向 loopIndex 的路由( 迁移时新 loop 可能已先登记 )
+	void Remove(std::string const& token, int const& loopIndex) noexcept;
+
+	// 找不到返回 -1
+	int Find(std::string const& token) noexcept;
+
+protected:
+	std::mutex mtx;
+	xx::Dict<std::string, int> loopByToken;
+};
+
+// 跨 loop 迁移的玩家数据( 只含值类型, 不跨线程共享对象 ). 由新连接所在 loop 填 token, 玩家所在 loop 填其余. id 为 0 表示没找到
+struct PlayerTransfer {
+	std::string token;
+	int id = 0;
+	std::string nickname;
+	int avatar_id = 0;
+	bool noMoney = false;
+	int64_t coin = 0;									// 含 飞行中子弹 退还的钱
+	int cannonCfgId = 0;
+	int64_t cannonCoin = 1;
+};
+
+struct Service {
+	// 所在 loop. 本服务及其游戏实例只在该 loop 线程中访问
+	xx::Uv& uv;
+
 	// 多协议监听器
 	xx::UvListener_s listener;
 
-	// 当前只有一个游戏实例
+	// 游戏实例( 管理本 loop 内的所有场景 & 玩家 )
 	std::shared_ptr<CatchFish> catchFish;
 
-	// 用于自增产生玩家 id
+	// 用于自增产生玩家 id( 有 routes 时改用 routes->playerAutoId )
 	int playerAutoId = 0;
 
+	// 多 loop 时的共享路由 及 本服务所在 loop 下标. 单 loop 时为空
+	PlayerRoutes* routes = nullptr;
+	int loopIndex = 0;
+
+	// 玩家收包 被限流 / 队列满 的累计次数( 触发即断开该连接 )
+	uint64_t numRecvRateLimited = 0;
+	uint64_t numRecvOverflows = 0;
+
 	// 定时器. 模拟一个游戏循环
 	xx::UvTimer_s looper;
 
@@ -32,5 +83,28 @@
 	// 拨号到 calc 服务器
 	void Dial_Calc();
 
-	Service();
+	// 产生一个玩家 id
+	int NextPlayerId() noexcept;
+
+	// 挑选场景 & 占座, 创建玩家并放入容器. from 非空 则以迁来的数据创建. 没空位 返回空
+	PKG::CatchFish::Player_s SeatPlayer(PlayerTransfer const* const& from = nullptr) noexcept;
+
+	// 断线重连的玩家在别的 loop: 投递到玩家所在 loop 执行 MovePlayerOut. 投递失败 返回非 0
+	int MovePlayer(std::shared_ptr<Peer> const& peer, std::string const& token, int const& ownerLoopIndex) noexcept;
+
+	// 于玩家所在 loop 执行: 踢掉其连接, 打包数据后 Cleanup, 再投递回 toLoopIndex 执行 MovePlayerIn
+	void MovePlayerOut(std::shared_ptr<PlayerTransfer>&& t, int const& toLoopIndex, std::weak_ptr<Peer>&& peer) noexcept;
+
+	// 于新连接所在 loop 执行: 以迁来的数据入座 并绑定 peer( peer 已断开 则留待超时清理 ). t->id 为 0 则按新玩家进入
+	void MovePlayerIn(std::shared_ptr<PlayerTransfer> const& t, std::weak_ptr<Peer> const& peer) noexcept;
+
+	// reusePort: 开启 SO_REUSEPORT, 以便 xx::UvGroup 每个 loop 各跑一个 Service 并监听同一端口
+	Service(xx::Uv& uv, bool const& reusePort = false);
+
+	// 使用已 CatchFish::LoadConfig 的配置. 多 loop 分片时 先加载一次, 再在每个 loop 中以同一 cfg 创建 Service
+	Service(xx::Uv& uv, PKG::CatchFish::Configs::Config_s const& cfg, bool const& reusePort = false);
+
+	// 多 loop 分片: 于 UvGroup::Start 的 init 中为第 loopIndex 个 loop 创建. 所有 Service 共享同一 routes
+	Service(xx::Uv& uv, PKG::CatchFish::Configs::Config_s const& cfg, PlayerRoutes& routes, int const& loopIndex);
+	~Service();
 };
@@ -1,10 +1,19 @@
-﻿inline Service::Service() {
-	// 创建游戏上下文并加载配置文件( 多个相同游戏上下文可共享同一配置文件 )
+﻿inline Service::Service(xx::Uv& uv, bool const& reusePort)
+	: Service(uv, nullptr, reusePort) {
+}
+
+inline Service::Service(xx::Uv& uv, PKG::CatchFish::Configs::Config_s const& cfg, bool const& reusePort)
+	: uv(uv) {
+	// 创建游戏上下文. 未传入配置就自己加载配置文件( 多个游戏上下文可共享同一配置 )
 	catchFish = xx::Make<CatchFish>();
-	if (int r = catchFish->Init("cfg.bin")) throw r;
+	catchFish->service = this;
+	if (int r = cfg ? catchFish->Init(cfg) : catchFish->Init("cfg.bin")) throw r;
 
 	// tcp, kcp 同时监听同一端口
-	listener = xx::Make<xx::UvListener>(uv, "0.0.0.0", 12345);
+	listener = xx::Make<xx::UvListener>(uv, "0.0.0.0", 12345, 2, reusePort);
+
+	// 客户端只发小包. 超长视为非法, 直接断开
+	listener->maxPackageLength = 64 * 1024;
 
 	// 为连接创建上下文对象并附加到连接. 同步生命周期
 	listener->onAccept = [this](xx::UvPeer_s peer) {
@@ -18,6 +27,9 @@
 		auto&& p = xx::TryMake<Peer>(uv);
 		p->service = this;
 		p->catchFish = &*catchFish;
+		// 发送积压超过 1M 视为客户端卡死, 断开( 重连后会收到完整的进入数据 )
+		p->sendHighWater = 1024 * 1024;
+		p->sendOverflowPolicy = 1;
 		return p;
 	};
 
@@ -36,6 +48,22 @@
 		});
 }
 
+inline Service::Service(xx::Uv& uv, PKG::CatchFish::Configs::Config_s const& cfg, PlayerRoutes& routes, int const& loopIndex)
+	: Service(uv, cfg, true) {
+	assert(loopIndex >= 0 && loopIndex < (int)routes.services.size());
+	this->routes = &routes;
+	this->loopIndex = loopIndex;
+	routes.services[loopIndex] = this;
+}
+
+inline Service::~Service() {
+	if (!routes) return;
+	routes->services[loopIndex] = nullptr;
+	for (auto&& p : catchFish->players) {
+		routes->Remove(p->token, loopIndex);
+	}
+}
+
 
 inline bool Service::IsAlive_CalcPeer() {
 	return calcPeer && !calcPeer->Disposed();
@@ -70,3 +98,194 @@ inline void Service::Dial_Calc() {
 		dialing = true;
 	}
 }
+
+inline void PlayerRoutes::Add(std::string const& token, int const& loopIndex) noexcept {
+	std::lock_guard<std::mutex> lg(mtx);
+	loopByToken.Add(token, loopIndex, true);
+}
+
+inline void PlayerRoutes::Remove(std::string const& token, int const& loopIndex) noexcept {
+	std::lock_guard<std::mutex> lg(mtx);
+	auto&& idx = loopByToken.Find(token);
+	if (idx != -1 && loopByToken.ValueAt(idx) == loopIndex) {
+		loopByToken.RemoveAt(idx);
+	}
+}
+
+inline int PlayerRoutes::Find(std::string const& token) noexcept {
+	std::lock_guard<std::mutex> lg(mtx);
+	auto&& idx = loopByToken.Find(token);
+	return idx == -1 ? -1 : loopByToken.ValueAt(idx);
+}
+
+inline int Service::NextPlayerId() noexcept {
+	return routes ? ++routes->playerAutoId : ++playerAutoId;
+}
+
+inline PKG::CatchFish::Player_s Service::SeatPlayer(PlayerTransfer const* const& from) noexcept {
+	// 引用到公共配置方便使用
+	auto&& cfg = *catchFish->cfg;
+
+	// 挑选要进入的 scene 并占座
+	PKG::CatchFish::Sits sit;
+	auto&& scenePtr = catchFish->Match(sit);
+	if (!scenePtr) return nullptr;
+	auto&& scene = *scenePtr;
+
+	// 构建玩家上下文( 模拟已从db读到了数据. 迁来的玩家 沿用原数据 )
+	auto&& player = xx::Make<PKG::CatchFish::Player>();
+	xx::MakeTo(player->cannons);
+	player->scene = &scene;
+	player->sit = sit;
+	player->pos = scene.cfg->sitPositons->At((int)sit);
+	player->autoFire = false;
+	player->autoIncId = 0;
+	player->autoLock = false;
+	xx::MakeTo(player->weapons);
+	if (from) {
+		player->id = from->id;
+		player->token = from->token;
+		player->coin = from->coin;
+		xx::MakeTo(player->nickname, from->nickname);
+		player->avatar_id = from->avatar_id;
+		player->noMoney = from->noMoney;
+	}
+	else {
+		player->id = NextPlayerId();
+		xx::Append(player->token, xx::Guid(true));
+		player->coin = 100000;
+		xx::MakeTo(player->nickname, "player_" + std::to_string(player->id));
+		player->avatar_id = 0;
+		player->noMoney = false;
+	}
+
+	// 构建初始炮台
+	auto&& cannonCfgId = from ? from->cannonCfgId : 0;
+	switch (cannonCfgId) {
+	case 0: {
+		auto&& cannonCfg = cfg.cannons->At(cannonCfgId);
+		auto&& cannon = xx::Make<PKG::CatchFish::Cannon>();
+		cannon->angle = float(cannonCfg->angle);
+		xx::MakeTo(cannon->bullets);
+		cannon->cfg = &*cannonCfg;
+		cannon->cfgId = cannonCfgId;
+		cannon->coin = from ? from->cannonCoin : 1;
+		cannon->id = (int)player->cannons->len;
+		cannon->player = &*player;
+		cannon->pos = cfg.sitPositons->At((int)sit);
+		cannon->quantity = cannonCfg->quantity;
+		cannon->scene = &scene;
+		cannon->fireCD = 0;
+		player->cannons->Add(cannon);
+		break;
+	}
+	// todo: more cannon types here
+	default:
+		xx::CoutTN("SeatPlayer unhandled cannon cfg id: ", cannonCfgId);
+		scene.freeSits->Add(sit);
+		return nullptr;
+	}
+
+	// 将玩家放入相应容器
+	catchFish->AddPlayer(player);
+	scene.players->Add(player);
+	scene.frameEnters.Add(&*player);
+
+	// 构建玩家进入通知并放入帧同步下发事件集合待发
+	{
+		auto&& enter = xx::Make<PKG::CatchFish::Events::Enter>();
+		enter->avatar_id = player->avatar_id;
+		enter->cannonCfgId = player->cannons->At(0)->cfgId;
+		enter->cannonCoin = player->cannons->At(0)->coin;
+		enter->coin = player->coin;
+		enter->nickname = player->nickname;
+		enter->noMoney = player->noMoney;
+		enter->playerId = player->id;
+		enter->sit = player->sit;
+		scene.frameEvents->events->Add(enter);
+	}
+
+	// 设置超时
+	player->ResetTimeoutFrameNumber();
+	return player;
+}
+
+inline int Service::MovePlayer(std::shared_ptr<Peer> const& peer, std::string const& token, int const& ownerLoopIndex) noexcept {
+	assert(routes && ownerLoopIndex != loopIndex);
+	auto&& t = std::make_shared<PlayerTransfer>();
+	t->token = token;
+	auto rs = routes;
+	auto to = loopIndex;
+	return routes->group.Dispatch(ownerLoopIndex, [rs, ownerLoopIndex, to, t = std::move(t), w = std::weak_ptr<Peer>(peer)]() mutable {
+		if (auto&& s = rs->services[ownerLoopIndex]) {
+			s->MovePlayerOut(std::move(t), to, std::move(w));
+		}
+		else {
+			// 玩家所在 loop 已无服务. 回去按新玩家进入
+			rs->group.Dispatch(to, [rs, to, t = std::move(t), w = std::move(w)] {
+				if (auto&& s = rs->services[to]) {
+					s->MovePlayerIn(t, w);
+				}
+			});
+		}
+	});
+}
+
+inline void Service::MovePlayerOut(std::shared_ptr<PlayerTransfer>&& t, int const& toLoopIndex, std::weak_ptr<Peer>&& peer) noexcept {
+	auto&& idx = catchFish->playerByToken.Find(t->token);
+	if (idx != -1) {
+		auto p = catchFish->playerByToken.ValueAt(idx).lock();
+		assert(p);
+		// 踢掉原有连接
+		p->Kick("move to loop ", toLoopIndex);
+
+		// 打包. 飞行中的子弹 退钱. 已提交 calc 的 hit 结果回来时玩家已不在, 由 MakeFishDead 记录
+		t->id = p->id;
+		t->nickname = p->nickname ? *p->nickname : std::string();
+		t->avatar_id = p->avatar_id;
+		t->noMoney = p->noMoney;
+		t->coin = p->coin;
+		auto&& c = p->cannons->At(0);
+		t->cannonCfgId = c->cfgId;
+		t->cannonCoin = c->coin;
+		for (auto&& cannon : *p->cannons) {
+			for (auto&& b : *cannon->bullets) {
+				t->coin += b->coin;
+			}
+		}
+
+		// 离开本 loop( 所在场景会下发 Leave )
+		catchFish->Cleanup(p);
+		xx::CoutTN("move player out: id = ", t->id, ", to loop ", toLoopIndex);
+	}
+	auto rs = routes;
+	if (int r = routes->group.Dispatch(toLoopIndex, [rs, toLoopIndex, t = std::move(t), w = std::move(peer)] {
+		if (auto&& s = rs->services[toLoopIndex]) {
+			s->MovePlayerIn(t, w);
+		}
+		else if (t->id) {
+			xx::CoutTN("move player lost: id = ", t->id, ", coin = ", t->coin);
+		}
+	})) {
+		xx::CoutTN("move player dispatch failed. r = ", r);
+	}
+}
+
+inline void Service::MovePlayerIn(std::shared_ptr<PlayerTransfer> const& t, std::weak_ptr<Peer> const& peer) noexcept {
+	auto&& player = SeatPlayer(t->id ? &*t : nullptr);
+	if (!player) {
+		xx::CoutTN("move player in failed: no more free sit. id = ", t->id, ", coin = ", t->coin);
+		if (auto&& p = peer.lock()) {
+			p->Dispose(1);
+		}
+		return;
+	}
+
+	// 玩家与连接绑定. 连接已断开 则玩家留待超时清理( 与断线玩家一致 )
+	auto&& p = peer.lock();
+	if (p && !p->Disposed()) {
+		p->player_w = player;
+		player->peer = std::move(p);
+	}
+	xx::CoutTN("move player in: ", player);
+}
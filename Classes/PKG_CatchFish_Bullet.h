@@ -10,6 +10,9 @@ PKG::CatchFish::Cannon* cannon = nullptr;
 // 指向具体配置( 由 Cannon 预填充, Bullet 与 Cannon 共享配置 )
 PKG::CatchFish::Configs::Cannon* cfg = nullptr;
 
+// 高频创建 & 销毁, 走池化分配
+static constexpr bool pooled = true;
+
 virtual int Update(int const& frameNumber) noexcept override;
 
 // 移动子弹。如果生命周期结束将返回非 0
@@ -51,10 +51,13 @@ inline int PKG::CatchFish::Bullet::Move() noexcept {
 inline int PKG::CatchFish::Bullet::Update(int const& frameNumber) noexcept {
 	if (int r = Move()) return r;
 #ifdef CC_TARGET_PLATFORM
-	// 遍历所有鱼
-	auto && fs = *scene->fishs;
-	if (fs.len) {
-		for (size_t i = fs.len - 1; i != -1; --i) {
+	// 遍历子弹所在格子中的鱼( 格子中的下标为升序, 倒序扫描与遍历所有鱼的命中优先级一致 )
+	auto&& fs = *scene->fishs;
+	int n = 0;
+	auto&& idxs = scene->fishGrid.At(pos, n);
+	if (n) {
+		for (int j = n - 1; j >= 0; --j) {
+			auto&& i = idxs[j];
 			// 命中检查
 			if (fs[i]->HitCheck(this)) {
 				// 如果是本人: 发命中检查包
@@ -71,7 +74,9 @@ inline int PKG::CatchFish::Bullet::Update(int const& frameNumber) noexcept {
 			}
 		}
 	}
-	DrawUpdate();
+	if (!scene->fastForwarding) {
+		DrawUpdate();
+	}
 #endif
 	return 0;
 };
@@ -18,6 +18,11 @@ int quantity = -1;
 
 virtual int Update(int const& frameNumber) noexcept override;
 
+#ifndef CC_TARGET_PLATFORM
+// 子弹 id 索引( 与 bullets 同步增删. Fire 时判重, Hit 时定位 )
+xx::Dict<int, PKG::CatchFish::Bullet*> bulletById;
+#endif
+
 // 发射子弹. 成功返回 true
 #ifndef CC_TARGET_PLATFORM
 // player 在遍历 recvs 的时候定位到炮台就 call 这个函数来发射
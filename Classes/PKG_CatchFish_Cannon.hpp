@@ -67,7 +67,9 @@ inline int PKG::CatchFish::Cannon::Update(int const& frameNumber) noexcept {
 			(void)Fire(tpos);	// 返回 0 表示 Fire 成功. 暂时不关注返回值
 		}
 	}
-	DrawUpdate();
+	if (!scene->fastForwarding) {
+		DrawUpdate();
+	}
 #endif
 
 	return 0;
@@ -92,90 +94,76 @@ inline int PKG::CatchFish::Cannon::SetCoin(PKG::Client_CatchFish::Bet_s& o) noex
 
 inline int PKG::CatchFish::Cannon::Hit(PKG::Client_CatchFish::Hit_s& o) noexcept {
 	// 合法性判断: 如果 fishId 找不到就忽略( fishId == 0 表示客户端主动取消该子弹, 退款 )
+	// 从子弹索引定位子弹. 当前炮台的子弹逻辑, 子弹 id 必须能被找到
+	auto&& bidx = bulletById.Find(o->bulletId);
+	if (bidx == -1) {
+		//xx::CoutN("hit bullet not found. ", o);
+		return -1;
+	}
 	auto&& bs = *this->bullets;
-	auto&& fs = *scene->fishs;
-	// 从子弹队列定位子弹. 如果队列为空直接认为 hit 失败. 当前炮台的子弹逻辑, 子弹 id 必须能被找到
-	if (bs.len) {
-		for (auto&& i = bs.len - 1; i != -1; --i) {
-			auto&& b = bs[i];
-			assert(b->indexAtContainer == i);
-			// 定位到子弹
-			if (b->id == o->bulletId) {
-				// 如果属于客户端 cancel, 直接退钱, 最后删子弹退出
-				if (!o->fishId) {
-					player->coin += b->coin;
-					player->MakeRefundEvent(b->coin);
-					//xx::CoutN("hit cancel. refund = ", b->coin);
-				}
-				else {
-					// 从鱼队列定位鱼. 如果找到就 fish die check( 本地逻辑进而直接下发 fishdie ). 没找到就退钱. 最后删子弹退出
-					if (fs.len) {
-						size_t j = fs.len - 1;
-						for (; j != -1; --j) {
-							auto&& f = fs[j];
-							assert(f->indexAtContainer == j);
-							// 定位到鱼
-							if (f->id == o->fishId) {
+	auto i = (size_t)bulletById.ValueAt(bidx)->indexAtContainer;
+	auto&& b = bs[i];
+	assert(&*b == bulletById.ValueAt(bidx));
+
+	// 如果属于客户端 cancel, 直接退钱, 最后删子弹退出
+	if (!o->fishId) {
+		player->coin += b->coin;
+		player->MakeRefundEvent(b->coin);
+		//xx::CoutN("hit cancel. refund = ", b->coin);
+	}
+	// 从鱼索引定位鱼. 如果找到就 fish die check( 本地逻辑进而直接下发 fishdie ). 没找到就退钱. 最后删子弹退出
+	else if (auto&& f = scene->FindFish(o->fishId)) {
 #if 1
-								// 远程计算逻辑( 依赖 Calc 服务 )
-								// 构造 hit 计算数据
-								auto && hit = scene->hitChecks->hits->Emplace();
-								hit.fishId = f->id;
-								hit.fishCoin = f->coin;
-								hit.playerId = player->id;
-								hit.cannonId = id;
-								hit.bulletId = b->id;
-								hit.bulletCount = 1;		// 写死. 当前子弹就是单颗
-								hit.bulletCoin = b->coin;
+		// 远程计算逻辑( 由 Scene 每帧批量发往 Calc 服务. Calc 不可用时 Scene 转为本地计算 )
+		// 构造 hit 计算数据
+		auto && hit = scene->hitChecks->hits->Emplace();
+		hit.fishId = f->id;
+		hit.fishCoin = f->coin;
+		hit.playerId = player->id;
+		hit.cannonId = id;
+		hit.bulletId = b->id;
+		hit.bulletCount = 1;		// 写死. 当前子弹就是单颗
+		hit.bulletCoin = b->coin;
 #else
-								// 本地计算逻辑( 不依赖 Calc 服务 )
-								// 先根据 1/coin 死亡比例 来判断是否打死
-								if (scene->serverRnd.Next((int)f->coin) == 0) {
-									// 算钱
-									auto&& c = b->coin * f->coin;	// 数量只可能为 1
-									// 构造鱼死事件包
-									{
-										auto&& fishDead = xx::Make<PKG::CatchFish::Events::FishDead>();
-										fishDead->cannonId = id;
-										fishDead->bulletId = b->id;
-										fishDead->coin = c;
-										fishDead->fishId = f->id;
-										fishDead->playerId = player->id;
-										scene->frameEvents->events->Add(std::move(fishDead));
-									}
-									// 加钱
-									player->coin += c;
-									// 删鱼
-									fs[fs.len - 1]->indexAtContainer = (int)j;
-									fs.SwapRemoveAt(j);
-									//xx::CoutN("hit fish dead. ", o);
-								}
-								else {
-									//xx::CoutN("hit fish not dead. ", o);
-								}
-#endif
-								break;
-							}
-						}
-						// 未找到鱼：退钱 & 构造退钱事件包
-						if (j == -1) {
-							player->coin += b->coin;
-							player->MakeRefundEvent(b->coin);
-							//xx::CoutN("hit miss. refund = ", b->coin);
-						}
-					}
-				}
-
-				//xx::CoutN("hit bullet success. ", o);
-				// 删子弹退出
-				bs[bs.len - 1]->indexAtContainer = (int)i;
-				bs.SwapRemoveAt(i);
-				return 0;
+		// 本地计算逻辑( 不依赖 Calc 服务 )
+		// 先根据 1/coin 死亡比例 来判断是否打死
+		if (scene->serverRnd.Next((int)f->coin) == 0) {
+			// 算钱
+			auto&& c = b->coin * f->coin;	// 数量只可能为 1
+			// 构造鱼死事件包
+			{
+				auto&& fishDead = xx::Make<PKG::CatchFish::Events::FishDead>();
+				fishDead->cannonId = id;
+				fishDead->bulletId = b->id;
+				fishDead->coin = c;
+				fishDead->fishId = f->id;
+				fishDead->playerId = player->id;
+				scene->frameEvents->events->Add(std::move(fishDead));
 			}
+			// 加钱
+			player->coin += c;
+			// 删鱼
+			scene->RemoveFishAt(f->indexAtContainer);
+			//xx::CoutN("hit fish dead. ", o);
 		}
+		else {
+			//xx::CoutN("hit fish not dead. ", o);
+		}
+#endif
+	}
+	// 未找到鱼：退钱 & 构造退钱事件包
+	else {
+		player->coin += b->coin;
+		player->MakeRefundEvent(b->coin);
+		//xx::CoutN("hit miss. refund = ", b->coin);
 	}
-	//xx::CoutN("hit bullet not found. ", o);
-	return -1;
+
+	//xx::CoutN("hit bullet success. ", o);
+	// 删子弹退出
+	bulletById.RemoveAt(bidx);
+	bs[bs.len - 1]->indexAtContainer = (int)i;
+	bs.SwapRemoveAt(i);
+	return 0;
 }
 #endif
 
@@ -195,9 +183,7 @@ inline int PKG::CatchFish::Cannon::Fire(PKG::Client_CatchFish::Fire_s& o) noexce
 	if (bullets->len == cfg->numLimit) return -5;
 
 	// 如果子弹编号已存在, 失败
-	for (auto&& bullet : *bullets) {
-		if (bullet->id == o->bulletId) return -1;
-	}
+	if (bulletById.Find(o->bulletId) != -1) return -1;
 
 	// todo: 更多发射限制检测
 
@@ -227,6 +213,7 @@ inline int PKG::CatchFish::Cannon::Fire(PKG::Client_CatchFish::Fire_s& o) noexce
 	bullet->moveInc = xx::Rotate(xx::Pos{ cfg->distance ,0 }, angle);							// 计算出每帧移动增量
 	bullet->indexAtContainer = (int)bullets->len;
 	bullets->Add(bullet);
+	bulletById.Add(bullet->id, &*bullet);
 
 	// 创建发射事件
 	{
@@ -72,6 +72,7 @@ inline PKG::CatchFish::Way_s PKG::CatchFish::Configs::Config::MakeBeeline(std::p
 	way->points->Add(PKG::CatchFish::WayPoint{ inOutPos.second, 0, 0 });	// 非循环轨迹最后个点距离和角度不用计算, 也不做统计
 	way->distance = way->points->At(0).distance;
 	way->loop = false;
+	way->FillCumDistances();
 	return way;
 }
 
@@ -92,5 +93,6 @@ inline PKG::CatchFish::Way_s PKG::CatchFish::Configs::Config::MakeCurve(std::pai
 	}
 
 	way->loop = false;
+	way->FillCumDistances();
 	return way;
 }
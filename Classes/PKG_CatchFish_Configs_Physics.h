@@ -1,4 +1,16 @@
-﻿cpSpace* space = nullptr;
+﻿// 由 polygons 预处理而来的凸多边形碎片( 每个多边形取凸包, 预算各边外法线 & 包围圆 ), 用于 点 + 半径 的碰撞判定
+struct Piece {
+	xx::Pos center;							// 包围圆心
+	float radius = 0;						// 包围圆半径
+	int from = 0;							// 于 verts / normals / dists 中的起始下标
+	int count = 0;							// 顶点数
+};
+xx::List<Piece> pieces;
+xx::List<xx::Pos> verts;					// 凸包顶点( 逆时针 )
+xx::List<xx::Pos> normals;					// 边 verts[i] -> verts[i + 1] 的单位外法线
+xx::List<float> dists;						// normals[i] 与 verts[i] 的点积( 即边所在直线到原点的有向距离 )
 
 virtual int InitCascade(void* const& o) noexcept override;
-~Physics();
+
+// 判断 以 p 为圆心, r 为半径的圆 是否与任意凸多边形相交( 等价于 点到多边形的有向距离 < r )
+bool HitCheck(xx::Pos const& p, float const& r) const noexcept;
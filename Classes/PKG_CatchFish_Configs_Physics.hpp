@@ -1,26 +1,99 @@
 ﻿inline int PKG::CatchFish::Configs::Physics::InitCascade(void* const& o) noexcept {
-	if (space) return 0;											// 多鱼共图
-	static_assert(sizeof(cpVect) == sizeof(xx::Pos));
-	if (polygons) {
-		space = cpSpaceNew();
-		auto&& body = cpSpaceGetStaticBody(space);
-		for (auto&& polygon : *polygons) {
-			auto&& shape = cpPolyShapeNew(body, (int)polygon->len, (cpVect*)polygon->buf, cpTransformIdentity, 0.0);
-			cpSpaceAddShape(space, shape);
+	if (pieces.len || !polygons) return 0;							// 多鱼共图
+	xx::List<xx::Pos> ps;
+	for (auto&& polygon : *polygons) {
+		if (!polygon->len) continue;
+
+		// 求凸包( Andrew 单调链, 去共线点. 结果为逆时针 )
+		ps.Clear();
+		for (auto&& v : *polygon) {
+			ps.Add(v);
+		}
+		std::sort(ps.buf, ps.buf + ps.len, [](xx::Pos const& a, xx::Pos const& b) {
+			return a.x < b.x || (a.x == b.x && a.y < b.y);
+		});
+		auto&& cross = [](xx::Pos const& o, xx::Pos const& a, xx::Pos const& b) {
+			return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+		};
+		auto from = verts.len;
+		for (size_t i = 0; i < ps.len; ++i) {						// 下链
+			while (verts.len >= from + 2 && cross(verts[verts.len - 2], verts[verts.len - 1], ps[i]) <= 0) verts.Pop();
+			verts.Add(ps[i]);
+		}
+		auto lower = verts.len + 1;
+		for (size_t i = ps.len - 1; i-- > 0;) {						// 上链
+			while (verts.len >= lower && cross(verts[verts.len - 2], verts[verts.len - 1], ps[i]) <= 0) verts.Pop();
+			verts.Add(ps[i]);
+		}
+		if (verts.len - from > 1) verts.Pop();						// 末点与首点重复
+		while (verts.len - from > 1 && verts.Top() == verts[from]) verts.Pop();	// 全部点重合
+
+		auto&& piece = pieces.Emplace();
+		piece.from = (int)from;
+		piece.count = int(verts.len - from);
+
+		// 边法线 & 包围圆
+		xx::Pos minXY = verts[from], maxXY = verts[from];
+		for (auto i = from; i < verts.len; ++i) {
+			auto&& a = verts[i];
+			auto&& b = verts[i + 1 == verts.len ? from : i + 1];
+			auto&& d = b - a;
+			auto&& len = sqrtf(d.x * d.x + d.y * d.y);
+			auto&& n = len > 0 ? xx::Pos{ d.y / len, -d.x / len } : xx::Pos{};
+			normals.Add(n);
+			dists.Add(n.x * a.x + n.y * a.y);
+			if (a.x < minXY.x) minXY.x = a.x;
+			if (a.y < minXY.y) minXY.y = a.y;
+			if (a.x > maxXY.x) maxXY.x = a.x;
+			if (a.y > maxXY.y) maxXY.y = a.y;
+		}
+		piece.center = (minXY + maxXY) / 2;
+		for (auto i = from; i < verts.len; ++i) {
+			auto&& dd = xx::GetDistance(piece.center, verts[i]);
+			if (dd > piece.radius) {
+				piece.radius = dd;
+			}
 		}
 	}
 	return 0;
 }
 
-inline PKG::CatchFish::Configs::Physics::~Physics() {
-	if (space) {
-		cpSpaceEachShape(space, [](cpShape *shape, void *data) {
-			cpSpaceAddPostStepCallback((cpSpace*)data, [](cpSpace *space, void *key, void *data) {
-				cpSpaceRemoveShape(space, (cpShape *)key);
-				cpShapeFree((cpShape *)key);
-			}, shape, nullptr);
-		}, space);
-		cpSpaceFree(space);
-		space = nullptr;
+inline bool PKG::CatchFish::Configs::Physics::HitCheck(xx::Pos const& p, float const& r) const noexcept {
+	for (auto&& piece : pieces) {
+		// 包围圆粗筛
+		auto&& cd = p - piece.center;
+		auto&& cr = piece.radius + r;
+		if (cd.x * cd.x + cd.y * cd.y >= cr * cr) continue;
+
+		// 求点到各边所在直线的最大有向距离. <= 0 表示在多边形内. 该值亦为点到多边形距离的下限
+		auto&& ns = normals.buf + piece.from;
+		auto&& ds = dists.buf + piece.from;
+		auto maxDist = ns[0].x * p.x + ns[0].y * p.y - ds[0];
+		for (int i = 1; i < piece.count; ++i) {
+			auto&& d = ns[i].x * p.x + ns[i].y * p.y - ds[i];
+			if (d > maxDist) {
+				maxDist = d;
+			}
+		}
+		if (piece.count >= 3) {
+			if (maxDist <= 0) return true;
+			if (maxDist >= r) continue;
+		}
+
+		// 在多边形外且可能够得着: 求点到各边线段的最短距离
+		auto&& vs = verts.buf + piece.from;
+		auto&& r2 = r * r;
+		for (int i = 0; i < piece.count; ++i) {
+			auto&& a = vs[i];
+			auto&& ab = vs[i + 1 == piece.count ? 0 : i + 1] - a;
+			auto&& ap = p - a;
+			auto&& ab2 = ab.x * ab.x + ab.y * ab.y;
+			auto&& t = ab2 > 0 ? (ap.x * ab.x + ap.y * ab.y) / ab2 : 0.0f;
+			if (t < 0) t = 0;
+			else if (t > 1) t = 1;
+			auto&& q = ap - ab * t;
+			if (q.x * q.x + q.y * q.y < r2) return true;
+		}
 	}
+	return false;
 }
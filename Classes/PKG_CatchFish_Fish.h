@@ -4,6 +4,9 @@ PKG::CatchFish::Scene* scene = nullptr;
 // 指向具体配置
 PKG::CatchFish::Configs::Fish* cfg = nullptr;
 
+// 高频创建 & 销毁, 走池化分配( 派生类随之开启 )
+static constexpr bool pooled = true;
+
 // 执行移动逻辑( frameRatio 控制了 Move 次数 )
 virtual int Update(int const& frameNumber) noexcept override;
 
@@ -13,6 +16,9 @@ virtual int Move() noexcept;
 // 碰撞检测。如果与传入子弹相撞则返回 1
 virtual int HitCheck(Bullet* const& bullet) noexcept;
 
+// 位于 scene->fishMover 中的下标. -1 表示不在
+int indexAtMover = -1;
+
 #ifdef CC_TARGET_PLATFORM
 virtual int InitCascade(void* const& o) noexcept override;
 
@@ -26,7 +26,9 @@ inline int PKG::CatchFish::Fish::Update(int const& frameNumber) noexcept {
 		if (int r = Move()) return r;
 	}
 #ifdef CC_TARGET_PLATFORM
-	DrawUpdate();
+	if (!scene->fastForwarding) {
+		DrawUpdate();
+	}
 #endif
 	return 0;
 };
@@ -46,14 +48,12 @@ int PKG::CatchFish::Fish::HitCheck(PKG::CatchFish::Bullet* const& bullet) noexce
 		auto&& r2 = cfg->maxDetectRadius * cfg->scale * this->scale + bullet->cfg->radius * bullet->cfg->scale;
 		if (r2 * r2 < d2) return 0;
 	}
-	// 3 判: 物理检测. 用子弹半径经过坐标转换, 去物理 space 选取 shapes. 如果有选到, 则判定成功
-	auto&& space = cfg->moveFrames->At(spriteFrameIndex)->physics->space;
+	// 3 判: 物理检测. 将子弹坐标 & 半径转换到鱼的帧图坐标系, 与预处理过的凸多边形做 圆 vs 多边形 判定
+	auto&& physics = cfg->moveFrames->At(spriteFrameIndex)->physics;
+	if (!physics) return 0;
 	auto&& s = cfg->scale * this->scale;
 	auto&& p = xx::Rotate(xx::Pos{ sqrtf(d2) / s, 0 }, this->angle - xx::GetAngle(pos, bullet->pos));
-	if (cpSpacePointQueryNearest(space, cpv(p.x, p.y), cpFloat(bullet->cfg->radius * bullet->cfg->scale / s), CP_SHAPE_FILTER_ALL, nullptr)) {
-		return 1;
-	}
-	return 0;
+	return physics->HitCheck(p, bullet->cfg->radius * bullet->cfg->scale / s) ? 1 : 0;
 }
 
 #ifdef CC_TARGET_PLATFORM
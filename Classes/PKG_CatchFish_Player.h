@@ -20,8 +20,51 @@ void ResetTimeoutFrameNumber() noexcept;
 template<typename ...Args>
 int Kick(Args const& ... reason) noexcept;
 
-// 收包容器( 在适当的生命周期读取并处理 )
-std::deque<xx::Object_s> recvs;
+// 收包容器: 定长槽位的环形队列( 随玩家对象一次分配, 收包时不再分配内存 )
+// 只存 Bet / Fire / Hit 的包体原始数据( 由 Peer::HandlePack 校验包头后放入 ), 在 Update 中处理时才反序列化
+struct Recvs {
+	static constexpr size_t slotSize = 32;				// 包体长度上限. 这几种包的包体都远小于此
+	static constexpr size_t capacity = 256;				// 槽位数( 2^n )
+
+	struct Slot {
+		uint16_t typeId;
+		uint8_t len;
+		uint8_t data[slotSize];
+	};
+	std::array<Slot, capacity> slots;
+	size_t head = 0;									// 下一个要读的槽位
+	size_t count = 0;
+
+	// 令牌桶. 以帧编号计时, 每帧补充 perSecond / 60 个令牌( 放大 60 倍存储以免小数 ), 最多积攒 burst 个
+	struct Limiter {
+		int perSecond;
+		int burst;
+		int64_t tokens = 0;
+		int lastFrameNumber = 0;
+
+		bool Take(int const& frameNumber) noexcept;
+	};
+	// 按消息类型限流: Bet, Fire, Hit. 正常客户端受 开火 CD & 子弹数量 限制, 远达不到
+	Limiter limiters[3] = { { 10, 10 }, { 60, 120 }, { 120, 240 } };
+
+	// 统计
+	uint64_t numPushs = 0;
+	uint64_t numRateLimited = 0;
+	uint64_t numOverflows = 0;
+
+	// 放入一个包体. limiterIndex 为 limiters 下标. 被限流 返回 -1, 队列已满 返回 -2, 包体过长 返回 -3
+	int Push(size_t const& limiterIndex, uint16_t const& typeId, uint8_t const* const& buf, size_t const& len, int const& frameNumber) noexcept;
+
+	Slot& Front() noexcept;
+	void Pop() noexcept;
+	void Clear() noexcept;
+};
+Recvs recvs;
+
+// 处理 recvs 时反序列化用的包对象( 每个 loop 线程一份, 反复用 )
+inline static thread_local PKG::Client_CatchFish::Bet_s recvBet = xx::Make<PKG::Client_CatchFish::Bet>();
+inline static thread_local PKG::Client_CatchFish::Fire_s recvFire = xx::Make<PKG::Client_CatchFish::Fire>();
+inline static thread_local PKG::Client_CatchFish::Hit_s recvHit = xx::Make<PKG::Client_CatchFish::Hit>();
 
 // 生成退钱事件
 void MakeRefundEvent(int64_t const& coin, int const& count = 1) noexcept;
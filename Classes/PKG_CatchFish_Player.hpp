@@ -61,22 +61,33 @@ inline int PKG::CatchFish::Player::Update(int const& frameNumber) noexcept {
 
 #ifdef CC_TARGET_PLATFORM
 	// 更新金币显示
-	DrawUpdate_Coin();
+	if (!scene->fastForwarding) {
+		DrawUpdate_Coin();
+	}
 
 #else
-	// 简单包堆积检测
-	if (recvs.size() > 200) return Kick("recvs.size() > 200");
-
 	// 是否产生有效操作
 	bool success = false;
 
+	// 将槽位中的包体反序列化到复用的包对象. 包体非法返回非 0
+	xx::BBuffer bb;
+	auto&& read = [&bb](xx::Object& o, Recvs::Slot& slot) {
+		bb.Reset(slot.data, slot.len);
+		int r = o.FromBBuffer(bb);
+		if (!r && bb.offset != bb.len) {
+			r = -1;
+		}
+		bb.Reset();
+		return r;
+	};
+
 	// 处理玩家的请求
-	while (!recvs.empty()) {
-		auto&& msg = recvs.front();
-		auto&& typeId = msg->GetTypeId();
-		switch (typeId) {
+	while (recvs.count) {
+		auto&& slot = recvs.Front();
+		switch (slot.typeId) {
 		case xx::TypeId_v<PKG::Client_CatchFish::Bet>: {
-			auto&& o = xx::As<PKG::Client_CatchFish::Bet>(msg);
+			auto&& o = recvBet;
+			if (read(*o, slot)) return Kick("bad Bet pkg");
 
 			// 倒着扫找炮 id
 			size_t i = cannons->len - 1;
@@ -96,7 +107,8 @@ inline int PKG::CatchFish::Player::Update(int const& frameNumber) noexcept {
 			break;
 		}
 		case xx::TypeId_v<PKG::Client_CatchFish::Fire>: {
-			auto&& o = xx::As<PKG::Client_CatchFish::Fire>(msg);
+			auto&& o = recvFire;
+			if (read(*o, slot)) return Kick("bad Fire pkg");
 
 			// 如果收到的包比 server 当前帧还要提前, 就等到那帧再处理
 			if (o->frameNumber > frameNumber) break;
@@ -119,7 +131,8 @@ inline int PKG::CatchFish::Player::Update(int const& frameNumber) noexcept {
 			break;
 		}
 		case xx::TypeId_v<PKG::Client_CatchFish::Hit>: {
-			auto&& o = xx::As<PKG::Client_CatchFish::Hit>(msg);
+			auto&& o = recvHit;
+			if (read(*o, slot)) return Kick("bad Hit pkg");
 
 			// 倒着扫找炮 id
 			size_t i = cannons->len - 1;
@@ -143,7 +156,7 @@ inline int PKG::CatchFish::Player::Update(int const& frameNumber) noexcept {
 		}
 
 		// 清掉当前指令
-		recvs.pop_front();
+		recvs.Pop();
 	}
 
 	if (success) {
@@ -158,6 +171,54 @@ inline int PKG::CatchFish::Player::Update(int const& frameNumber) noexcept {
 
 #ifndef CC_TARGET_PLATFORM
 
+inline bool PKG::CatchFish::Player::Recvs::Limiter::Take(int const& frameNumber) noexcept {
+	auto&& max = (int64_t)burst * 60;
+	tokens += (int64_t)(frameNumber - lastFrameNumber) * perSecond;
+	if (tokens > max) {
+		tokens = max;
+	}
+	lastFrameNumber = frameNumber;
+	if (tokens < 60) return false;
+	tokens -= 60;
+	return true;
+}
+
+inline int PKG::CatchFish::Player::Recvs::Push(size_t const& limiterIndex, uint16_t const& typeId, uint8_t const* const& buf, size_t const& len, int const& frameNumber) noexcept {
+	assert(limiterIndex < _countof(limiters));
+	if (len > slotSize) return -3;
+	if (!limiters[limiterIndex].Take(frameNumber)) {
+		++numRateLimited;
+		return -1;
+	}
+	if (count == capacity) {
+		++numOverflows;
+		return -2;
+	}
+	auto&& slot = slots[(head + count) & (capacity - 1)];
+	slot.typeId = typeId;
+	slot.len = (uint8_t)len;
+	memcpy(slot.data, buf, len);
+	++count;
+	++numPushs;
+	return 0;
+}
+
+inline PKG::CatchFish::Player::Recvs::Slot& PKG::CatchFish::Player::Recvs::Front() noexcept {
+	assert(count);
+	return slots[head];
+}
+
+inline void PKG::CatchFish::Player::Recvs::Pop() noexcept {
+	assert(count);
+	head = (head + 1) & (capacity - 1);
+	--count;
+}
+
+inline void PKG::CatchFish::Player::Recvs::Clear() noexcept {
+	head = 0;
+	count = 0;
+}
+
 inline void PKG::CatchFish::Player::ResetTimeoutFrameNumber() noexcept {
 	if (peer && !peer->Disposed()) {
 		peer->ResetTimeoutMS(10000);
@@ -168,7 +229,7 @@ inline void PKG::CatchFish::Player::ResetTimeoutFrameNumber() noexcept {
 template<typename ...Args>
 inline int PKG::CatchFish::Player::Kick(Args const& ... reason) noexcept {
 	xx::CoutTN("Kick player id = ", id, ", reason = ", reason...);
-	recvs.clear();
+	recvs.Clear();
 	if (peer) {
 		peer->Dispose(1);
 		peer.reset();
@@ -4,6 +4,58 @@ PKG::CatchFish::Configs::Config* cfg = nullptr;
 // 指向所在服务实例. 由 Scene 创建者或调用 InitCascade 前填充.
 ::CatchFish* catchFish = nullptr;
 
+// 关卡实例缓存( 下标即关卡 id ). InitStages 时由 cfg->stageBufs 一次性反序列化 & InitCascade, 之后切关只原地 Reset 复用
+xx::List<PKG::CatchFish::Stages::Stage_s> stages;
+
+// 关卡实例的完整 元素 / 监视器 备份( 运行时 stage->elements / monitors 中的项会被移除, 切关时据此还原 )
+xx::List<xx::List<PKG::CatchFish::Stages::StageElement_s>> stageElements;
+xx::List<xx::List<PKG::CatchFish::Stages::StageElement_s>> stageMonitors;
+
+// 创建所有关卡实例. 需先填充 cfg
+int InitStages() noexcept;
+
+// 切换到指定关卡( 重置缓存中的实例 并令 stage 指向它. 不分配内存, 不反序列化 )
+void SwitchStage(int const& stageId) noexcept;
+
+// 直线鱼( 类型恰为 Fish 且 frameRatio == 1 )移动数据的 SoA 镜像. Update 时先整体批量( SIMD )移动, 再在遍历鱼时回写到鱼对象
+// 鱼对象依然是权威数据( 序列化, 绘制, 碰撞 均用它 ). 镜像中未被本帧遍历到的项( 鱼已被别处移除 )于遍历结束后清除
+struct FishMover {
+	xx::List<float> xs, ys;							// 坐标
+	xx::List<float> incXs, incYs;					// moveInc * speedScale
+	xx::List<float> ws, hs;							// 出界判定范围: designSize_2 + 鱼半径
+	xx::List<int> frameIdxs, frameLens;				// spriteFrameIndex, cfg->moveFrames->len
+	xx::List<int> deads;							// 本帧 移动后 出界 则为非 0
+	xx::List<int> stamps;							// 最后一次被 Pull / Add 时的帧编号
+	xx::List<Fish*> fishs;							// 对应的鱼( 只于 stamps 为当前帧时访问 )
+
+	// 判断鱼是否符合条件 并 放入镜像
+	void TryAdd(Fish* const& f, int const& frameNumber) noexcept;
+
+	// 批量移动所有项一次
+	void Move() noexcept;
+
+	// 将镜像中的移动结果回写到鱼. 不在镜像中返回 1, 出界返回 -1, 正常返回 0
+	int Pull(Fish* const& f, int const& frameNumber) noexcept;
+
+	// 清除本帧未被 Pull / Add 的项
+	void Sweep(int const& frameNumber) noexcept;
+
+	void SwapRemoveAt(size_t const& idx) noexcept;
+};
+FishMover fishMover;
+
+// 鱼 id 索引( 与 fishs 同步增删. 值为鱼对象, 其 indexAtContainer 即 fishs 下标 )
+xx::Dict<int, PKG::CatchFish::Fish*> fishById;
+
+// 将鱼放入 fishs 并建立索引
+void AddFish(PKG::CatchFish::Fish_s const& fish) noexcept;
+
+// 从 fishs 交换删除某下标的鱼 并移除索引
+void RemoveFishAt(size_t const& idx) noexcept;
+
+// 用 id 定位鱼. 找不到返回 nullptr
+PKG::CatchFish::Fish* FindFish(int const& fishId) const noexcept;
+
 #ifndef CC_TARGET_PLATFORM
 // 自减id ( 从 -1 开始, 用于服务器下发鱼生成 )
 int autoDecId = 0;
@@ -17,26 +69,66 @@ PKG::CatchFish_Client::FrameEvents_s frameEvents;
 // 记录本帧刚进入的新玩家( 帧结束时清空 ) 用以判断是下发完整同步还是帧事件同步
 xx::List<void*> frameEnters;
 
-// 记录本次 update 过程产生的各式 hit 计算请求
+// 记录本次 update 过程产生的各式 hit 计算请求( 发出后移入 calcRequests, 再从 hitChecksPool 取一个接着填 )
 PKG::CatchFish_Calc::HitCheck_s hitChecks;
 
-// 计算结果更新( 回调 )
-void UpdateCalc(xx::Object_s&& msg) noexcept;
+// 已发给 Calc 尚未收到结果的 hit 计算请求( 按发出顺序 ). 超时 / 出错 时据此退款
+struct CalcRequest {
+	int frameNumber;								// 发出时的帧编号( 即批次标记. 每帧最多发出一批 )
+	PKG::CatchFish_Calc::HitCheck_s hitChecks;
+};
+xx::List<CalcRequest> calcRequests;
+
+// 处理完的 hitChecks 回收于此重用
+xx::List<PKG::CatchFish_Calc::HitCheck_s> hitChecksPool;
 
-// 计算结果的具体处理代码
+// 同时在途的 hit 计算请求上限. 达到上限 或 Calc 未就绪 时, 当帧 hit 改为本地计算, 场景不等待
+int maxCalcRequests = 8;
+
+// 计算结果更新( 回调 ). frameNumber 为请求发出时的帧编号
+void UpdateCalc(int const& frameNumber, xx::Object_s&& msg) noexcept;
+
+// 计算结果的具体处理代码( 结果于后续某帧到达, 产生的事件随当前帧下发 )
 void Handle(PKG::Calc_CatchFish::HitCheckResult_s&& msg) noexcept;
 
+// 本地计算一批 hit( 按 1 / fishCoin 的比例判定打死, 鱼已消失则退款 )
+void LocalHitCheck(PKG::CatchFish_Calc::HitCheck const& o) noexcept;
+
+// 退还一批 hit 的子弹钱( Calc 超时 / 出错 时 )
+void RefundHitCheck(PKG::CatchFish_Calc::HitCheck const& o) noexcept;
+
+// 令鱼死掉, 给玩家加钱, 生成鱼死事件. 鱼已不在( 被别的在途批次打死 / 游出屏幕 )则退还子弹钱 refundCoin. 玩家已离开则记日志( 鱼也不死 )
+void MakeFishDead(int const& playerId, int const& cannonId, int const& bulletId, int const& fishId, int64_t const& coin, int64_t const& refundCoin) noexcept;
+
+// 给玩家退钱 并生成退钱事件. 玩家已离开则记日志
+void MakeRefund(int const& playerId, int64_t const& coin) noexcept;
+
 // 更新最后阶段：发包
 void UpdateEnd() noexcept;
 
-// hit 计算结果，同时也是执行标志位. 发起 Request 时该值为 1. 超时为 -1, 正常退出为 0
-int calcResult = 0;
+// 完整同步( EnterSuccess )包缓存. 本帧有玩家进入时才构造: 公共部分( scene + players )只序列化一次, 每个进入者只追加 self + token
+xx::BBuffer enterSuccessBB;
+
+// enterSuccessBB 中公共部分的长度
+size_t enterSuccessBBLen = 0;
 
-// 辅助计算容器
-xx::List<int> fishIds;
+// 构造 enterSuccessBB 公共部分时用的玩家容器( 反复用 )
+xx::List_s<PKG::CatchFish::Player_s> enterSuccessPlayers;
 #else
 // 将 Scene 指针刷到所有子
 virtual int InitCascade(void* const& o = nullptr) noexcept override;
+
+// 子弹 vs 鱼 碰撞检测用 宽相网格. 每帧 鱼移动 & 出生 之后重建, 玩家( 子弹 )更新时查询
+xx::SpaceGrid fishGrid;
+
+// 鱼放入网格时的半径附加值( 所有炮台配置中子弹的最大半径 ). 令子弹只需查询所在的一个格子
+float fishGridMargin = 0;
+
+// 重建 fishGrid
+void BuildFishGrid() noexcept;
+
+// 刷新所有 鱼, 玩家, 炮台, 子弹 的显示
+void DrawUpdate() noexcept;
 #endif
 
 // 随机生成一对具备合理显示效果的进出屏幕的关键点
@@ -50,3 +142,14 @@ PKG::CatchFish::BigFish_s MakeRandomBigFish(int const& fishId) noexcept;
 
 // 帧逻辑更新
 int Update() noexcept;
+
+// 追帧中( 为 true 时 各 Update 跳过 DrawUpdate )
+bool fastForwarding = false;
+
+// 追帧: 不绘制 地连续 Update 直到 frameNumber == targetFrameNumber, 结束后统一刷新一次显示
+// 服务器没有绘制, 等同于连续 Update. 两端共用, 以便 headless 比对 追帧 与 逐帧 的结果
+int FastForward(int const& targetFrameNumber) noexcept;
+
+// 场景状态 hash: 将场景( 含 鱼, 玩家, 炮台, 子弹, 随机数 ... )序列化后对字节流求 FNV-1a
+// 用于逐帧比对 重构前后 / 不同平台 的计算结果是否 bit 级一致( 见 LOG_SCENE_HASH )
+uint64_t CalcHash() const noexcept;
@@ -1,4 +1,5 @@
 ﻿#include "PKG_CatchFish_Scene_MakeFishs.hpp"
+#include "PKG_CatchFish_Scene_FishMover.hpp"
 
 #ifdef CC_TARGET_PLATFORM
 inline int PKG::CatchFish::Scene::InitCascade(void* const& o) noexcept {
@@ -9,36 +10,195 @@ inline int PKG::CatchFish::Scene::InitCascade(void* const& o) noexcept {
 	int r = InitCascadeCore(this);
 	// 还原
 	this->borns = std::move(borns);
+	if (r) return r;
+
+	// 创建关卡实例缓存( 当前关卡沿用下发的实例, 切关时才改用缓存 )
+	if ((r = InitStages())) return r;
+
+	// 重建鱼 id 索引
+	fishById.Clear();
+	for (auto&& f : *fishs) {
+		fishById.Add(f->id, &*f);
+	}
+
+	// 初始化鱼网格
+	fishGridMargin = 0;
+	for (auto&& c : *cfg->cannons) {
+		auto&& br = c->radius * c->scale;
+		if (br > fishGridMargin) {
+			fishGridMargin = br;
+		}
+	}
+	fishGrid.Init(::designSize, 80);
 	return r;
 }
-#endif
 
-inline int PKG::CatchFish::Scene::Update() noexcept {
-#ifndef CC_TARGET_PLATFORM
-	// 如果到计算服务的连接未就绪, 无限等待			// todo: 超时处理
-	if (!service->IsAlive_CalcPeer()) {
-		xx::CoutTN("waiting Calc service...");
-		return 0;
+inline void PKG::CatchFish::Scene::BuildFishGrid() noexcept {
+	fishGrid.Clear();
+	auto&& fs = *fishs;
+	for (size_t i = 0; i < fs.len; ++i) {
+		auto&& f = fs[i];
+		assert(f->indexAtContainer == (int)i);
+		// 无最大检测半径配置的鱼 不受半径限制, 覆盖全部格子
+		auto&& r = f->cfg->maxDetectRadius > 0 ? f->cfg->maxDetectRadius * f->cfg->scale * f->scale + fishGridMargin : 0.0f;
+		fishGrid.Add((int)i, f->pos, r);
 	}
+	fishGrid.Build();
+}
 
-	// 如果正在等待计算服回调, 就直接返回. ( 正常情况下不该发生. 除非与 Calc 连接异常 )
-	if (calcResult) return calcResult > 0 ? 0 : calcResult;
+inline void PKG::CatchFish::Scene::DrawUpdate() noexcept {
+	for (auto&& f : *fishs) {
+		f->DrawUpdate();
+	}
+	for (auto&& w : *players) {
+		auto&& p = xx::As<Player>(w.lock());
+		if (!p) continue;
+		for (auto&& c : *p->cannons) {
+			for (auto&& b : *c->bullets) {
+				b->DrawUpdate();
+			}
+			c->DrawUpdate();
+		}
+		p->DrawUpdate_Coin();
+	}
+}
 #endif
 
+inline int PKG::CatchFish::Scene::FastForward(int const& targetFrameNumber) noexcept {
+	fastForwarding = true;
+	int r = 0;
+	while (frameNumber < targetFrameNumber) {
+		if ((r = Update())) break;
+	}
+	fastForwarding = false;
+#ifdef CC_TARGET_PLATFORM
+	if (!r) {
+		DrawUpdate();
+	}
+#endif
+	return r;
+}
+
+inline int PKG::CatchFish::Scene::InitStages() noexcept {
+	assert(cfg && !stages.len);
+	auto&& n = cfg->stageBufs.len;
+	stages.Reserve(n);
+	stageElements.Reserve(n);
+	stageMonitors.Reserve(n);
+	// cfg 可能被多个 loop 线程的场景共享, 不能改其中 BBuffer 的 offset. 用临时 BBuffer 引用其内存来读
+	xx::BBuffer bb;
+	for (size_t i = 0; i < n; ++i) {
+		auto&& src = cfg->stageBufs[i];
+		bb.Reset(src.buf, src.len);
+		auto&& s = stages.Emplace();
+		int r = bb.ReadRoot(s);
+		bb.Reset();
+		if (r) return r;
+		if ((r = s->InitCascade(this))) return r;
+		// 逐个 Add 复制( 智能指针被视作 IsTrivial, AddRange 会直接 memcpy 而不增加引用计数 )
+		auto&& ebs = stageElements.Emplace();
+		for (auto&& e : *s->elements) {
+			ebs.Add(e);
+		}
+		auto&& mbs = stageMonitors.Emplace();
+		for (auto&& m : *s->monitors) {
+			mbs.Add(m);
+		}
+	}
+	return 0;
+}
+
+inline void PKG::CatchFish::Scene::SwitchStage(int const& stageId) noexcept {
+	assert(stageId >= 0 && stageId < (int)stages.len);
+	auto&& s = stages[stageId];
+	auto&& tmpl = *cfg->stages->At(stageId);
+	s->ticks = tmpl.ticks;
+
+	// 按备份还原元素列表( 容量不变, 不会分配 ), 并从模板还原运行时字段
+	auto&& es = *s->elements;
+	auto&& ebs = stageElements[stageId];
+	es.Clear();
+	for (size_t i = 0; i < ebs.len; ++i) {
+		ebs[i]->Reset(*tmpl.elements->At(i));
+		es.Add(ebs[i]);
+	}
+	auto&& ms = *s->monitors;
+	auto&& mbs = stageMonitors[stageId];
+	ms.Clear();
+	for (size_t i = 0; i < mbs.len; ++i) {
+		mbs[i]->Reset(*tmpl.monitors->At(i));
+		ms.Add(mbs[i]);
+	}
+
+	stage = s;
+}
+
+inline void PKG::CatchFish::Scene::AddFish(PKG::CatchFish::Fish_s const& fish) noexcept {
+	auto&& r = fishById.Add(fish->id, &*fish);
+	assert(r.success);
+	(void)r;
+	fish->indexAtContainer = (int)fishs->len;
+	fishs->Add(fish);
+}
+
+inline void PKG::CatchFish::Scene::RemoveFishAt(size_t const& idx) noexcept {
+	auto&& fs = *fishs;
+	assert(fs[idx]->indexAtContainer == (int)idx);
+	fishById.Remove(fs[idx]->id);
+	fs[fs.len - 1]->indexAtContainer = (int)idx;
+	fs.SwapRemoveAt(idx);
+}
+
+inline PKG::CatchFish::Fish* PKG::CatchFish::Scene::FindFish(int const& fishId) const noexcept {
+	auto&& idx = fishById.Find(fishId);
+	return idx == -1 ? nullptr : fishById.ValueAt(idx);
+}
+
+inline uint64_t PKG::CatchFish::Scene::CalcHash() const noexcept {
+	// 序列化用( 每个 loop 线程一份, 反复用 )
+	static thread_local xx::BBuffer bb;
+	bb.Clear();
+	bb.offsetRoot = 0;
+	ToBBuffer(bb);
+	bb.ptrs.Clear();
+
+	uint64_t h = 14695981039346656037ull;
+	for (size_t i = 0; i < bb.len; ++i) {
+		h = (h ^ bb.buf[i]) * 1099511628211ull;
+	}
+	return h;
+}
+
+inline int PKG::CatchFish::Scene::Update() noexcept {
 	// 一开始就累加帧数, 确保后续步骤( 含追帧递归 )生命周期正确
 	++frameNumber;
 
+	// 批量移动直线鱼( 结果于下面遍历时回写 )
+	fishMover.Move();
+
 	// 遍历更新. 倒序扫描, 交换删除. 如果存在内部乱序删除的情况, 则需要 名单机制 或 标记机制 在更新结束之后挨个删掉
 	auto&& fs = *fishs;
 	if (fs.len) {
 		for (size_t i = fs.len - 1; i != -1; --i) {
-			assert(fs[i]->indexAtContainer == (int)i);
-			if (fs[i]->Update(frameNumber)) {
-				fs[fs.len - 1]->indexAtContainer = (int)i;
-				fs.SwapRemoveAt(i);
+			auto&& f = fs[i];
+			assert(f->indexAtContainer == (int)i);
+			int r = fishMover.Pull(&*f, frameNumber);
+			if (r > 0) {
+				if (!(r = f->Update(frameNumber))) {
+					fishMover.TryAdd(&*f, frameNumber);
+				}
+			}
+#ifdef CC_TARGET_PLATFORM
+			else if (!r && !fastForwarding) {
+				f->DrawUpdate();
+			}
+#endif
+			if (r) {
+				RemoveFishAt(i);
 			}
 		}
 	}
+	fishMover.Sweep(frameNumber);
 
 	// 倒序遍历 items. Update 返回非 0 则杀掉
 	auto&& is = *items;
@@ -54,11 +214,7 @@ inline int PKG::CatchFish::Scene::Update() noexcept {
 	assert(stage);
 	assert(stage->ticks <= stage->cfg_endTicks);
 	if (stage->ticks == stage->cfg_endTicks) {
-		int stageId = stage->cfg_id == cfg->stages->len - 1 ? 0 : stage->cfg_id + 1;
-		cfg->stageBufs[stageId].offset = 0;
-		int r = cfg->stageBufs[stageId].ReadRoot(stage);
-		assert(!r);
-		stage->InitCascade(this);
+		SwitchStage(stage->cfg_id == cfg->stages->len - 1 ? 0 : stage->cfg_id + 1);
 	}
 
 	// 取出关卡 ticks 备用
@@ -109,8 +265,7 @@ inline int PKG::CatchFish::Scene::Update() noexcept {
 			auto&& b = bs[i];
 			assert(b->beginFrameNumber >= frameNumber);
 			if (b->beginFrameNumber == frameNumber) {
-				b->fish->indexAtContainer = (int)fs.len;
-				fs.Add(b->fish);
+				AddFish(b->fish);
 #ifdef CC_TARGET_PLATFORM
 				b->fish->InitCascade(this);
 #endif
@@ -119,6 +274,11 @@ inline int PKG::CatchFish::Scene::Update() noexcept {
 		}
 	}
 
+#ifdef CC_TARGET_PLATFORM
+	// 鱼的位置 & 数量已定, 重建网格供子弹碰撞检测
+	BuildFishGrid();
+#endif
+
 	// 倒序遍历玩家，Update 返回非 0 则杀掉( 玩家会进一步驱动 cannons, bullets )
 	auto&& ps = *players;
 	if (ps.len) {
@@ -135,149 +295,174 @@ inline int PKG::CatchFish::Scene::Update() noexcept {
 		}
 	}
 
+#if LOG_SCENE_HASH
+	xx::CoutTN("scene hash. roomId = ", roomId, ", frameNumber = ", frameNumber, ", hash = ", CalcHash());
+#endif
+
 #ifndef CC_TARGET_PLATFORM
 	if (hitChecks->hits->len) {
-		// 设置标志位
-		calcResult = 1;
-
-		// 将 hitChecks 发给 Calc 计算
-		service->calcPeer->SendRequest(hitChecks, [this](xx::Object_s && msg)->int { UpdateCalc(std::move(msg)); return 0; }, 1000);
-
-		// 清理 for next fill
-		hitChecks->hits->Clear();
-	}
-	else {
-		// 直接做后续 Update
-		UpdateEnd();
-		calcResult = 0;
+		// 将 hitChecks 发给 Calc 计算( 不等结果, 场景继续推进 ). 发送成功则移入在途队列并换一个接着填
+		auto&& service = catchFish->service;
+		if (service->IsAlive_CalcPeer() && calcRequests.len < (size_t)maxCalcRequests
+			&& !service->calcPeer->SendRequest(hitChecks, [this, fn = frameNumber](xx::Object_s && msg)->int {
+				UpdateCalc(fn, std::move(msg));
+				return 0;
+			}, 1000)) {
+			calcRequests.Emplace(CalcRequest{ frameNumber, std::move(hitChecks) });
+			if (!hitChecksPool.TryPop(hitChecks)) {
+				xx::MakeTo(hitChecks);
+				xx::MakeTo(hitChecks->hits);
+			}
+		}
+		// Calc 不可用 或 在途过多: 本地计算
+		else {
+			LocalHitCheck(*hitChecks);
+			hitChecks->hits->Clear();
+		}
 	}
+	UpdateEnd();
 #endif
 	return 0;
 };
 
 #ifndef CC_TARGET_PLATFORM
-inline void PKG::CatchFish::Scene::UpdateCalc(xx::Object_s && msg) noexcept {
-	// 超时检查
-	if (!msg) {
-		xx::CoutTN("recv timeout.");
-		calcResult = -1;
-		return;
+inline void PKG::CatchFish::Scene::UpdateCalc(int const& frameNumber, xx::Object_s && msg) noexcept {
+	// 按批次标记定位在途请求( 通常就是第一个 ). 找不到说明已处理过, 忽略
+	size_t i = 0;
+	for (; i < calcRequests.len; ++i) {
+		if (calcRequests[i].frameNumber == frameNumber) break;
 	}
+	if (i == calcRequests.len) return;
+	auto hcs = std::move(calcRequests[i].hitChecks);		// RemoveAt 会移动后面的项. 不存 && 引用
+	calcRequests.RemoveAt(i);
 
-	switch (msg->GetTypeId()) {
-	case xx::TypeId_v<PKG::Calc_CatchFish::HitCheckResult>: {
-		Handle(xx::As<PKG::Calc_CatchFish::HitCheckResult>(msg));
-		calcResult = 0;
-		break;
-	}
-	case xx::TypeId_v<PKG::Generic::Error>: {
-		xx::CoutTN("recv error: ", msg);
-		calcResult = -2;
-		break;
+	// 超时检查
+	if (!msg) {
+		xx::CoutTN("recv timeout. frameNumber = ", frameNumber);
+		RefundHitCheck(*hcs);
 	}
-	default:
-		xx::CoutTN("recv unhandled msg: ", msg);
-		calcResult = -3;
-		break;
+	else {
+		switch (msg->GetTypeId()) {
+		case xx::TypeId_v<PKG::Calc_CatchFish::HitCheckResult>: {
+			Handle(xx::As<PKG::Calc_CatchFish::HitCheckResult>(msg));
+			break;
+		}
+		case xx::TypeId_v<PKG::Generic::Error>: {
+			xx::CoutTN("recv error: ", msg);
+			RefundHitCheck(*hcs);
+			break;
+		}
+		default:
+			xx::CoutTN("recv unhandled msg: ", msg);
+			RefundHitCheck(*hcs);
+			break;
+		}
 	}
+
+	// 回收
+	hcs->hits->Clear();
+	hitChecksPool.Add(std::move(hcs));
 }
 
 inline void PKG::CatchFish::Scene::Handle(PKG::Calc_CatchFish::HitCheckResult_s && msg) noexcept {
 	// 令相应的鱼死掉( 子弹在 hit 请求产生时便已被移除 ), 同步玩家 coin, 生成各种 鱼死 & 退款 事件
 
 	for (auto&& f : *msg->fishs) {
-		// 放入待删除列表
-		fishIds.Add(f.fishId);
-
-		// 算钱
-		auto&& c = f.fishCoin * f.bulletCoin;	// 数量只可能是 1
-
-		// 构造鱼死事件包
-		{
-			auto&& fishDead = xx::Make<PKG::CatchFish::Events::FishDead>();
-			fishDead->playerId = f.playerId;
-			fishDead->cannonId = f.cannonId;
-			fishDead->bulletId = f.bulletId;
-			fishDead->fishId = f.fishId;
-			fishDead->coin = c;
-			frameEvents->events->Add(std::move(fishDead));
-		}
+		MakeFishDead(f.playerId, f.cannonId, f.bulletId, f.fishId, f.fishCoin * f.bulletCoin, f.bulletCoin);	// 数量只可能是 1
+	}
 
-		// 定位到玩家加钱
-		auto&& j = players->len - 1;
-		for (; j != -1; --j) {
-			auto&& player = players->At(j).lock();
-			assert(player);
-			if (player->id == f.playerId) {
-				player->coin += c;
-				break;
-			}
-		}
-		assert(j != -1);
+	// 批量退钱
+	for (auto&& b : *msg->bullets) {
+		MakeRefund(b.playerId, b.bulletCoin * b.bulletCount);	// todo: 为退钱增加 bulletId 以便与鱼死关联？
 	}
+}
 
-	// 批量删鱼 by fishIds
-	auto&& fs = *fishs;
-	if (fs.len && fishIds.len) {
-		for (size_t j = fs.len - 1; j != -1; --j) {
-			auto&& f = fs[j];
-			assert(f->indexAtContainer == j);
-			// 如果 鱼id 存在于 fishIds
-			if (auto && idx = fishIds.Find(f->id); idx != -1) {
-				// 删鱼id
-				fishIds.SwapRemoveAt(idx);
-				// 删鱼
-				fs[fs.len - 1]->indexAtContainer = (int)j;
-				fs.SwapRemoveAt(j);
+inline void PKG::CatchFish::Scene::LocalHitCheck(PKG::CatchFish_Calc::HitCheck const& o) noexcept {
+	for (auto&& h : *o.hits) {
+		// 鱼还在就根据 1/coin 死亡比例 来判断是否打死, 没打死则子弹消耗掉. 鱼已消失( 可能被在途结果打死 )就退钱
+		if (FindFish(h.fishId)) {
+			if (serverRnd.Next((int)h.fishCoin) == 0) {
+				MakeFishDead(h.playerId, h.cannonId, h.bulletId, h.fishId, h.fishCoin * h.bulletCoin * h.bulletCount, h.bulletCoin * h.bulletCount);
 			}
-			// 没鱼删了 直接退出
-			if (!fishIds.len) break;
+		}
+		else {
+			MakeRefund(h.playerId, h.bulletCoin * h.bulletCount);
 		}
 	}
+}
 
-	// cleanup
-	fishIds.Clear();
+inline void PKG::CatchFish::Scene::RefundHitCheck(PKG::CatchFish_Calc::HitCheck const& o) noexcept {
+	for (auto&& h : *o.hits) {
+		MakeRefund(h.playerId, h.bulletCoin * h.bulletCount);
+	}
+}
 
-	// 批量退钱
-	for (auto&& b : *msg->bullets) {
-		// 定位到玩家退钱 & 生成退钱事件包
-		auto&& j = players->len - 1;
-		for (; j != -1; --j) {
-			auto&& player = players->At(j).lock();
-			assert(player);
-			if (player->id == b.playerId) {
-				auto&& c = b.bulletCoin * b.bulletCount;
-				player->coin += c;
-				player->MakeRefundEvent(c);	// todo: 为退钱增加 bulletId 以便与鱼死关联？
-				break;
-			}
-		}
-		assert(j != -1);
+inline void PKG::CatchFish::Scene::MakeFishDead(int const& playerId, int const& cannonId, int const& bulletId, int const& fishId, int64_t const& coin, int64_t const& refundCoin) noexcept {
+	// 结果异步到达, 期间玩家可能已离开. 此时不杀鱼不下发, 以免客户端收到无主的鱼死. 记下来便于对账
+	auto&& player = catchFish->FindPlayer(playerId);
+	if (!player) {
+		xx::CoutTN("MakeFishDead: player left. roomId = ", roomId, ", playerId = ", playerId, ", fishId = ", fishId, ", coin = ", coin);
+		return;
 	}
 
-	UpdateEnd();
+	// 同一条鱼可能出现在多个在途批次中, 或已被别处移除: 只有第一个结果算数, 其余视作没打中, 退子弹钱
+	auto&& fish = FindFish(fishId);
+	if (!fish) {
+		MakeRefund(playerId, refundCoin);
+		return;
+	}
+	RemoveFishAt(fish->indexAtContainer);
+
+	// 构造鱼死事件包
+	{
+		auto&& fishDead = xx::Make<PKG::CatchFish::Events::FishDead>();
+		fishDead->playerId = playerId;
+		fishDead->cannonId = cannonId;
+		fishDead->bulletId = bulletId;
+		fishDead->fishId = fishId;
+		fishDead->coin = coin;
+		frameEvents->events->Add(std::move(fishDead));
+	}
+
+	// 加钱
+	player->coin += coin;
+}
+
+inline void PKG::CatchFish::Scene::MakeRefund(int const& playerId, int64_t const& coin) noexcept {
+	if (auto&& player = catchFish->FindPlayer(playerId)) {
+		player->coin += coin;
+		player->MakeRefundEvent(coin);
+	}
+	else {
+		xx::CoutTN("MakeRefund: player left. roomId = ", roomId, ", playerId = ", playerId, ", coin = ", coin);
+	}
 }
 
 inline void PKG::CatchFish::Scene::UpdateEnd() noexcept {
 	// 存帧序号
 	frameEvents->frameNumber = frameNumber;
 
-	// todo: 要进一步减少重复序列化 scene, 就得修改完整同步流程, 将 self + token 分离发送
-
-	// 预构造完整同步，减少冗余	
-	PKG::CatchFish_Client::EnterSuccess_s enterSuccess;
+	// 预构造完整同步的公共部分. 等同于 WriteRoot( EnterSuccess ) 写到 self 之前( 字段顺序同 EnterSuccess::ToBBuffer )
+	// ptrs 保留到本帧发完, 令每个进入者追加的 self 能引用到 players 中的玩家
+	auto&& bb = enterSuccessBB;
 	if (frameEnters.len) {
-		xx::MakeTo(enterSuccess);
-		xx::MakeTo(enterSuccess->players);
+		if (!enterSuccessPlayers) {
+			xx::MakeTo(enterSuccessPlayers);
+		}
 		for (auto&& plr_w : *players) {
-			enterSuccess->players->Add(plr_w.lock());
+			enterSuccessPlayers->Add(plr_w.lock());
 		}
-		enterSuccess->scene = catchFish->scene;		// todo: 如果是多个服务器实例则需要用 key 定位
-		// 这两个不填充
-		//enterSuccess->self
-		//enterSuccess->token
+		bb.Clear();
+		bb.offsetRoot = 0;
+		bb.WritePtrHeader(xx::TypeId_v<PKG::CatchFish_Client::EnterSuccess>);
+		bb.Write(catchFish->scenes[roomId], enterSuccessPlayers);
+		enterSuccessBBLen = bb.len;
+		enterSuccessPlayers->Clear();
 	}
 
+	// 帧事件只序列化一次, 共享给所有老玩家发送
+	xx::BBuffer_s frameEventsPkg;
+
 	// 将本帧事件推送给玩家
 	for (auto&& plr_w : *players) {
 		auto&& plr = xx::As<Player>(plr_w.lock());
@@ -285,19 +470,22 @@ inline void PKG::CatchFish::Scene::UpdateEnd() noexcept {
 		if (plr->peer && !plr->peer->Disposed()) {
 			// 如果是本帧内进入的玩家, 就下发完整同步
 			if (frameEnters.Find(&*plr) != -1) {
-				// 继续填充私有部分
-				enterSuccess->self = plr_w;
-				xx::MakeTo(enterSuccess->token, plr->token);
+				// 截断到公共部分, 追加私有部分: self, token( std::string 的 typeId 为 1 )
+				bb.len = enterSuccessBBLen;
+				bb.Write(plr_w);
+				bb.WritePtrHeader(1);
+				bb.Write(plr->token);
 				// 发送
-				plr->peer->SendPush(enterSuccess);
-				plr->peer->Flush();
+				plr->peer->SendPush(bb);
 			}
 			// 老玩家直接下发帧事件同步数据
 			else {
 				// 如果有数据就立即下发, 没有就慢发
 				if (frameEvents->events->len || !(frameNumber & 0xF)) {
-					plr->peer->SendPush(frameEvents);
-					plr->peer->Flush();
+					if (!frameEventsPkg) {
+						frameEventsPkg = xx::UvPeer::MakeSharedPackage(frameEvents);
+					}
+					plr->peer->SendSharedPush(frameEventsPkg);
 				}
 			}
 		}
@@ -313,6 +501,7 @@ inline void PKG::CatchFish::Scene::UpdateEnd() noexcept {
 
 	frameEvents->events->Clear();		// 清除发送过的数据
 	frameEnters.Clear();				// 清除发送过的数据
+	bb.ptrs.Clear();					// 其中的指针本帧之后可能失效
 }
 
 #endif
@@ -0,0 +1,118 @@
+﻿#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FISH_MOVER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FISH_MOVER_NEON 1
+#endif
+
+inline void PKG::CatchFish::Scene::FishMover::TryAdd(Fish* const& f, int const& frameNumber) noexcept {
+	if (f->frameRatio != 1 || f->GetTypeId() != xx::TypeId_v<PKG::CatchFish::Fish>) return;
+	f->indexAtMover = (int)fishs.len;
+	fishs.Add(f);
+	xs.Add(f->pos.x);
+	ys.Add(f->pos.y);
+	// 与 Fish::Move 的计算顺序保持一致, 确保结果一致
+	auto&& inc = f->moveInc * f->speedScale;
+	incXs.Add(inc.x);
+	incYs.Add(inc.y);
+	auto&& radius = f->cfg->maxDetectRadius * f->cfg->scale * f->scale;
+	ws.Add(designSize_2.x + radius);
+	hs.Add(designSize_2.y + radius);
+	frameIdxs.Add(f->spriteFrameIndex);
+	frameLens.Add((int)f->cfg->moveFrames->len);
+	deads.Add(0);
+	stamps.Add(frameNumber);
+}
+
+inline void PKG::CatchFish::Scene::FishMover::Move() noexcept {
+	auto len = fishs.len;
+	auto&& xs = this->xs.buf;
+	auto&& ys = this->ys.buf;
+	auto&& incXs = this->incXs.buf;
+	auto&& incYs = this->incYs.buf;
+	auto&& ws = this->ws.buf;
+	auto&& hs = this->hs.buf;
+	auto&& frameIdxs = this->frameIdxs.buf;
+	auto&& frameLens = this->frameLens.buf;
+	auto&& deads = this->deads.buf;
+	size_t i = 0;
+#if FISH_MOVER_SSE2
+	auto&& absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	auto&& one = _mm_set1_epi32(1);
+	for (; i + 4 <= len; i += 4) {
+		auto&& x = _mm_add_ps(_mm_loadu_ps(xs + i), _mm_loadu_ps(incXs + i));
+		auto&& y = _mm_add_ps(_mm_loadu_ps(ys + i), _mm_loadu_ps(incYs + i));
+		_mm_storeu_ps(xs + i, x);
+		_mm_storeu_ps(ys + i, y);
+		auto&& d = _mm_or_ps(_mm_cmpgt_ps(_mm_and_ps(x, absMask), _mm_loadu_ps(ws + i)), _mm_cmpgt_ps(_mm_and_ps(y, absMask), _mm_loadu_ps(hs + i)));
+		_mm_storeu_si128((__m128i*)(deads + i), _mm_castps_si128(d));
+		auto&& fi = _mm_add_epi32(_mm_loadu_si128((__m128i*)(frameIdxs + i)), one);
+		fi = _mm_andnot_si128(_mm_cmpeq_epi32(fi, _mm_loadu_si128((__m128i*)(frameLens + i))), fi);
+		_mm_storeu_si128((__m128i*)(frameIdxs + i), fi);
+	}
+#elif FISH_MOVER_NEON
+	auto&& one = vdupq_n_s32(1);
+	for (; i + 4 <= len; i += 4) {
+		auto&& x = vaddq_f32(vld1q_f32(xs + i), vld1q_f32(incXs + i));
+		auto&& y = vaddq_f32(vld1q_f32(ys + i), vld1q_f32(incYs + i));
+		vst1q_f32(xs + i, x);
+		vst1q_f32(ys + i, y);
+		auto&& d = vorrq_u32(vcgtq_f32(vabsq_f32(x), vld1q_f32(ws + i)), vcgtq_f32(vabsq_f32(y), vld1q_f32(hs + i)));
+		vst1q_s32(deads + i, vreinterpretq_s32_u32(d));
+		auto&& fi = vaddq_s32(vld1q_s32(frameIdxs + i), one);
+		fi = vbicq_s32(fi, vreinterpretq_s32_u32(vceqq_s32(fi, vld1q_s32(frameLens + i))));
+		vst1q_s32(frameIdxs + i, fi);
+	}
+#endif
+	for (; i < len; ++i) {
+		xs[i] += incXs[i];
+		ys[i] += incYs[i];
+		deads[i] = fabsf(xs[i]) > ws[i] || fabsf(ys[i]) > hs[i];
+		if (++frameIdxs[i] == frameLens[i]) {
+			frameIdxs[i] = 0;
+		}
+	}
+}
+
+inline int PKG::CatchFish::Scene::FishMover::Pull(Fish* const& f, int const& frameNumber) noexcept {
+	auto i = f->indexAtMover;
+	if (i < 0 || i >= (int)fishs.len || fishs[i] != f) return 1;
+	f->pos.x = xs[i];
+	f->pos.y = ys[i];
+	if (deads[i]) {
+		// 出界: Fish::Move 此时不推进帧下标. 不打 stamp, 由 Sweep 清除
+		f->indexAtMover = -1;
+		return -1;
+	}
+	f->spriteFrameIndex = frameIdxs[i];
+	stamps[i] = frameNumber;
+	return 0;
+}
+
+inline void PKG::CatchFish::Scene::FishMover::Sweep(int const& frameNumber) noexcept {
+	if (!fishs.len) return;
+	// 倒序扫描: 交换删除时 移到 i 的末尾项 必然已检查过( stamp 有效, 鱼指针可访问 )
+	for (int i = (int)fishs.len - 1; i >= 0; --i) {
+		if (stamps[i] != frameNumber) {
+			SwapRemoveAt(i);
+			if (i < (int)fishs.len) {
+				fishs[i]->indexAtMover = i;
+			}
+		}
+	}
+}
+
+inline void PKG::CatchFish::Scene::FishMover::SwapRemoveAt(size_t const& idx) noexcept {
+	xs.SwapRemoveAt(idx);
+	ys.SwapRemoveAt(idx);
+	incXs.SwapRemoveAt(idx);
+	incYs.SwapRemoveAt(idx);
+	ws.SwapRemoveAt(idx);
+	hs.SwapRemoveAt(idx);
+	frameIdxs.SwapRemoveAt(idx);
+	frameLens.SwapRemoveAt(idx);
+	deads.SwapRemoveAt(idx);
+	stamps.SwapRemoveAt(idx);
+	fishs.SwapRemoveAt(idx);
+}
@@ -21,8 +21,7 @@ inline int PKG::CatchFish::Stages::Emitter_CircleFishs::Update(int const& ticks)
 		fish->frameRatio = 1;
 		angle += cfg_angleIncrease;
 
-		fish->indexAtContainer = (int)scene->fishs->len;
-		scene->fishs->Add(fish);
+		scene->AddFish(fish);
 #ifdef CC_TARGET_PLATFORM
 		fish->DrawInit();
 #endif
@@ -32,3 +31,10 @@ inline int PKG::CatchFish::Stages::Emitter_CircleFishs::Update(int const& ticks)
 	}
 	return 0;
 }
+
+inline void PKG::CatchFish::Stages::Emitter_CircleFishs::Reset(PKG::CatchFish::Stages::StageElement const& tmpl) noexcept {
+	this->BaseType::Reset(tmpl);
+	auto&& t = (ThisType const&)tmpl;
+	bornAvaliableTicks = t.bornAvaliableTicks;
+	angle = t.angle;
+}
@@ -7,8 +7,7 @@ inline int PKG::CatchFish::Stages::Emitter_RandomFishs::Update(int const& ticks)
 	if (bornAvaliableTicks <= ticks) {
 		// 立刻生成小鱼并放入容器
 		auto&& fish = scene->MakeRandomFish(++scene->autoIncId, cfg_coin, cfg_scaleFrom, cfg_scaleTo);
-		fish->indexAtContainer = (int)scene->fishs->len;
-		scene->fishs->Add(fish);
+		scene->AddFish(fish);
 #ifdef CC_TARGET_PLATFORM
 		fish->DrawInit();
 #endif
@@ -17,3 +16,9 @@ inline int PKG::CatchFish::Stages::Emitter_RandomFishs::Update(int const& ticks)
 	}
 	return 0;
 }
+
+inline void PKG::CatchFish::Stages::Emitter_RandomFishs::Reset(PKG::CatchFish::Stages::StageElement const& tmpl) noexcept {
+	this->BaseType::Reset(tmpl);
+	auto&& t = (ThisType const&)tmpl;
+	bornAvaliableTicks = t.bornAvaliableTicks;
+}
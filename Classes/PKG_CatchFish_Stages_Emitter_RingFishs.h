@@ -3,3 +3,4 @@ PKG::CatchFish::Scene* scene = nullptr;
 
 virtual int InitCascade(void* const& o) noexcept override;
 virtual int Update(int const& ticks) noexcept override;
+virtual void Reset(PKG::CatchFish::Stages::StageElement const& tmpl) noexcept override;
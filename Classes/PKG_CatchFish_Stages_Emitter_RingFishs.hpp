@@ -24,8 +24,7 @@ inline int PKG::CatchFish::Stages::Emitter_RingFishs::Update(int const& ticks) n
 			fish->moveInc = xx::Rotate({ cfg_speed ,0 }, a);
 			fish->frameRatio = 1;
 
-			fish->indexAtContainer = (int)scene->fishs->len;
-			scene->fishs->Add(fish);
+			scene->AddFish(fish);
 #ifdef CC_TARGET_PLATFORM
 			fish->DrawInit();
 #endif
@@ -36,3 +35,9 @@ inline int PKG::CatchFish::Stages::Emitter_RingFishs::Update(int const& ticks) n
 	}
 	return 0;
 }
+
+inline void PKG::CatchFish::Stages::Emitter_RingFishs::Reset(PKG::CatchFish::Stages::StageElement const& tmpl) noexcept {
+	this->BaseType::Reset(tmpl);
+	auto&& t = (ThisType const&)tmpl;
+	bornAvaliableTicks = t.bornAvaliableTicks;
+}
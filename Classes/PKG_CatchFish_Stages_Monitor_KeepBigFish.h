@@ -6,3 +6,4 @@ std::shared_ptr<int> counter;
 
 virtual int InitCascade(void* const& o) noexcept override;
 virtual int Update(int const& ticks) noexcept override;
+virtual void Reset(PKG::CatchFish::Stages::StageElement const& tmpl) noexcept override;
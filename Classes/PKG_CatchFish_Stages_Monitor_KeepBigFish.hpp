@@ -28,3 +28,9 @@ inline int PKG::CatchFish::Stages::Monitor_KeepBigFish::Update(int const& ticks)
 #endif
 	return 0;
 }
+
+inline void PKG::CatchFish::Stages::Monitor_KeepBigFish::Reset(PKG::CatchFish::Stages::StageElement const& tmpl) noexcept {
+	this->BaseType::Reset(tmpl);
+	auto&& t = (ThisType const&)tmpl;
+	bornAvaliableTicks = t.bornAvaliableTicks;
+}
@@ -1 +1,4 @@
 ﻿virtual int Update(int const& ticks) noexcept;
+
+// 关卡切换复用时, 从配置模板( cfg->stages 中同位置的原始元素 )还原运行时字段
+virtual void Reset(PKG::CatchFish::Stages::StageElement const& tmpl) noexcept;
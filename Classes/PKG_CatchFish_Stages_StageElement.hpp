@@ -1,3 +1,7 @@
 ﻿inline int PKG::CatchFish::Stages::StageElement::Update(int const& ticks) noexcept {
 	return 0;
 }
+
+inline void PKG::CatchFish::Stages::StageElement::Reset(PKG::CatchFish::Stages::StageElement const& tmpl) noexcept {
+	assert(tmpl.GetTypeId() == GetTypeId());
+}
@@ -0,0 +1,11 @@
+﻿// 累计路程表: cumDistances[i] 为 起点 到 points[i] 的路程. 长度为 points->len + 1, 末项为 循环一圈 的总路程
+// 路点数据生成后不再改变, 于 InitCascade 或 首次 Forward 时填充
+xx::List<float> cumDistances;
+
+virtual int InitCascade(void* const& o = nullptr) noexcept override;
+
+// 填充 cumDistances
+void FillCumDistances() noexcept;
+
+// 从 index 号路点上已走 indexDistance 处 前进 dist. 不跨点则直接累加, 跨点则 二分查表 定位. 非循环路径走出终点返回 -1
+int Forward(float const& dist, int32_t& index, float& indexDistance) noexcept;
@@ -0,0 +1,62 @@
+﻿inline int PKG::CatchFish::Way::InitCascade(void* const& o) noexcept {
+	if (int r = InitCascadeCore(o)) return r;
+	FillCumDistances();
+	return 0;
+}
+
+inline void PKG::CatchFish::Way::FillCumDistances() noexcept {
+	auto&& ps = *points;
+	cumDistances.Resize(ps.len + 1);
+	float d = 0;
+	for (size_t i = 0; i < ps.len; ++i) {
+		cumDistances[i] = d;
+		d += ps[i].distance;
+	}
+	cumDistances[ps.len] = d;
+}
+
+inline int PKG::CatchFish::Way::Forward(float const& dist, int32_t& index, float& indexDistance) noexcept {
+	auto&& ps = *points;
+	assert(index >= 0 && index < (int)ps.len);
+
+	// 快速路径: 不跨点
+	auto&& left = ps[index].distance - indexDistance;
+	if (dist <= left) {
+		indexDistance += dist;
+		return 0;
+	}
+
+	if (cumDistances.len != ps.len + 1) {
+		FillCumDistances();
+	}
+	auto&& cs = cumDistances.buf;
+
+	// 算出前进后的 总路程. 循环路径 可走的范围是 整圈, 非循环路径 到 最后一个点 为止
+	auto&& n = loop ? ps.len : ps.len - 1;
+	auto s = cs[index] + indexDistance + dist;
+	if (s > cs[n]) {
+		if (!loop || cs[n] <= 0) return -1;
+		s = fmodf(s, cs[n]);
+		if (s == 0) {
+			s = cs[n];												// 与逐点扣减一致: 恰好走完一圈 停在最后一段的末尾
+		}
+	}
+
+	// 找到 cs[i] < s <= cs[i + 1] 的 i ( 与逐点扣减时 "dist > left 才跨点" 一致, 零长度路段 自然被跳过 )
+	auto&& i = int(std::lower_bound(cs, cs + n + 1, s) - cs) - 1;
+	if (i < 0) {
+		i = 0;
+	}
+	else if (i >= (int)n) {
+		i = (int)n - 1;
+	}
+	index = i;
+	indexDistance = s - cs[i];
+	if (indexDistance > ps[i].distance) {
+		indexDistance = ps[i].distance;
+	}
+	else if (indexDistance < 0) {
+		indexDistance = 0;
+	}
+	return 0;
+}
@@ -335,6 +335,7 @@ namespace CatchFish::Events {
 
         typedef Event ThisType;
         typedef xx::Object BaseType;
+        static constexpr bool pooled = true;
 	    Event() = default;
 		Event(Event const&) = delete;
 		Event& operator=(Event const&) = delete;
@@ -1232,6 +1233,7 @@ namespace Client_CatchFish {
 
         typedef Fire ThisType;
         typedef xx::Object BaseType;
+        static constexpr bool pooled = true;
 	    Fire() = default;
 		Fire(Fire const&) = delete;
 		Fire& operator=(Fire const&) = delete;
@@ -1251,6 +1253,7 @@ namespace Client_CatchFish {
 
         typedef Hit ThisType;
         typedef xx::Object BaseType;
+        static constexpr bool pooled = true;
 	    Hit() = default;
 		Hit(Hit const&) = delete;
 		Hit& operator=(Hit const&) = delete;
@@ -1458,7 +1461,8 @@ namespace CatchFish {
         uint16_t GetTypeId() const noexcept override;
         void ToBBuffer(xx::BBuffer& bb) const noexcept override;
         int FromBBuffer(xx::BBuffer& bb) noexcept override;
-        int InitCascade(void* const& o = nullptr) noexcept override;
+        int InitCascadeCore(void* const& o = nullptr) noexcept;
+#include <PKG_CatchFish_Way.h>
     };
     // 基于路径移动的鱼基类
     struct WayFish : PKG::CatchFish::Fish {
@@ -2567,7 +2571,7 @@ namespace CatchFish {
         if (int r = bb.Read(this->loop)) return r;
         return 0;
     }
-    inline int Way::InitCascade(void* const& o) noexcept {
+    inline int Way::InitCascadeCore(void* const& o) noexcept {
         if (this->points) {
             if (int r = this->points->InitCascade(o)) return r;
         }
@@ -4,6 +4,7 @@
 #include <PKG_CatchFish_Cannon.hpp>
 #include <PKG_CatchFish_Bullet.hpp>
 #include <PKG_CatchFish_Fish.hpp>
+#include <PKG_CatchFish_Way.hpp>
 #include <PKG_CatchFish_WayFish.hpp>
 #include <PKG_CatchFish_RoundFish.hpp>
 #include <PKG_CatchFish_BigFish.hpp>
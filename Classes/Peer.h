@@ -11,8 +11,11 @@ struct Peer : xx::UvPeer {
 	// 首包判断 flag
 	bool isFirstPackage = true;
 
-	// 预创建 反复用
-	inline static PKG::Generic::Pong_s pkgPong = xx::Make<PKG::Generic::Pong>();
+	// 预创建 反复用( 每个 loop 线程一份 )
+	inline static thread_local PKG::Generic::Pong_s pkgPong = xx::Make<PKG::Generic::Pong>();
+
+	// 已绑定玩家时 拦截推送: 不反序列化, 校验包头 & 限流后 将包体放入 player->recvs. 其他情况走常规流程
+	virtual int HandlePack(uint8_t* const& recvBuf, uint32_t const& recvLen) noexcept override;
 
 	// 处理推送( 被原始 peer 调用 )
 	virtual int ReceivePush(xx::Object_s&& msg) noexcept override;
@@ -21,24 +21,72 @@ inline int Peer::ReceiveRequest(int const& serial, xx::Object_s&& msg) noexcept
 	}
 }
 
-inline int Peer::ReceivePush(xx::Object_s&& msg) noexcept {
+inline int Peer::HandlePack(uint8_t* const& recvBuf, uint32_t const& recvLen) noexcept {
+	// û bind: ߳
+	auto&& player = player_w.lock();
+	if (!player) return this->xx::UvPeer::HandlePack(recvBuf, recvLen);
+
+	// Ѱ. ͷ: serial,  typeId & ƫ
+	xx::BBuffer bb;
+	bb.Reset(recvBuf, recvLen);
+	int serial = 0;
+	uint16_t typeId = 0;
+	size_t offs = 0, typeIdLen = 0;
+	int r = bb.Read(serial);
+	if (!r && serial) {
+		//  / Ӧ( ping  ) ճ
+		bb.Reset();
+		return this->xx::UvPeer::HandlePack(recvBuf, recvLen);
+	}
+	if (!r) {
+		typeIdLen = bb.offset;
+		r = bb.Read(typeId);
+		typeIdLen = bb.offset - typeIdLen;
+	}
+	if (!r) {
+		r = bb.Read(offs);
+	}
+	auto bodyOffset = bb.offset;
+	bb.Reset();
+	// ״γ, ƫ Ȼ typeId ռ
+	if (r || offs != typeIdLen) {
+		xx::CoutTN("binded recv bad package.");
+		return -1;
+	}
 
-	//  bind
-	if (auto && player = player_w.lock()) {
-		// Ѱ
-		// жϷϢ, ʵʱʹ, ģ
-		auto&& typeId = msg->GetTypeId();
-		if (typeId != xx::TypeId_v<PKG::Client_CatchFish::Bet>
-			&& typeId != xx::TypeId_v<PKG::Client_CatchFish::Fire>
-			&& typeId != xx::TypeId_v<PKG::Client_CatchFish::Hit>) {
-			xx::CoutTN("binded recv unhandled push: ", msg);
-			return -1;
+	// ֻ⼸. жϷϢ, ʵʱʹ, ģ
+	size_t limiterIndex;
+	switch (typeId) {
+	case xx::TypeId_v<PKG::Client_CatchFish::Bet>:
+		limiterIndex = 0;
+		break;
+	case xx::TypeId_v<PKG::Client_CatchFish::Fire>:
+		limiterIndex = 1;
+		break;
+	case xx::TypeId_v<PKG::Client_CatchFish::Hit>:
+		limiterIndex = 2;
+		break;
+	default:
+		xx::CoutTN("binded recv unhandled push. typeId = ", typeId);
+		return -1;
+	}
+	if ((r = player->recvs.Push(limiterIndex, typeId, recvBuf + bodyOffset, recvLen - bodyOffset, player->scene->frameNumber))) {
+		if (r == -1) {
+			++service->numRecvRateLimited;
+		}
+		else if (r == -2) {
+			++service->numRecvOverflows;
 		}
-		player->recvs.push_back(msg);
-		return 0;
+		xx::CoutTN("binded recv push failed. r = ", r, ", typeId = ", typeId, ", player id = ", player->id);
+		return r;
 	}
-	// û bind
-	else {
+	return 0;
+}
+
+inline int Peer::ReceivePush(xx::Object_s&& msg) noexcept {
+	// Ѱҵ  HandlePack , ߵ
+	assert(player_w.expired());
+	{
 		if (!isFirstPackage) return -1;
 		isFirstPackage = false;
 
@@ -47,110 +95,50 @@ inline int Peer::ReceivePush(xx::Object_s&& msg) noexcept {
 		case xx::TypeId_v<PKG::Client_CatchFish::Enter>: {
 			auto&& o = xx::As<PKG::Client_CatchFish::Enter>(msg);
 
-			// õ÷ʹ
-			auto&& cfg = *catchFish->cfg;
-
-			// жҪĸ scene (ǰһ,  )
-			auto&& scene = *catchFish->scene;
-
 			// д id, Ŷλ, ߶߼
 			while (o->token) {
 				//  token 
-				for(auto&& p : catchFish->players) {
-					if (p->token == *o->token) {
-						assert(p->peer != shared_from_this());
-						// ߵԭ( : ͻ˺ܾûյ, Լ redial,  server ûֶ )
-						p->Kick(GetIP(), " reconnect");
-						// Ӱ
-						player_w = p;
-						p->peer = xx::As<Peer>(shared_from_this());
-						// 뱾֡Ϸб, Ա·ͬ
-						scene.frameEnters.Add(&*p);
-						// óʱ
-						p->ResetTimeoutFrameNumber();
-						// سɹ
-						return 0;
+				auto&& idx = catchFish->playerByToken.Find(*o->token);
+				if (idx == -1) break;
+				auto&& p = catchFish->playerByToken.ValueAt(idx).lock();
+				assert(p);
+				assert(p->peer != shared_from_this());
+				// ߵԭ( : ͻ˺ܾûյ, Լ redial,  server ûֶ )
+				p->Kick(GetIP(), " reconnect");
+				// Ӱ
+				player_w = p;
+				p->peer = xx::As<Peer>(shared_from_this());
+				// ڳ֡Ϸб, Ա·ͬ
+				p->scene->frameEnters.Add(&*p);
+				// óʱ
+				p->ResetTimeoutFrameNumber();
+				// سɹ
+				return 0;
+			}
+
+			//  loop ʱ ҿڱ loop:  loop ժ, Ǩ loop ٰ. ڼ䱾ӱ
+			if (o->token && service->routes) {
+				auto&& loopIndex = service->routes->Find(*o->token);
+				if (loopIndex != -1 && loopIndex != service->loopIndex) {
+					if (int r = service->MovePlayer(xx::As<Peer>(shared_from_this()), *o->token, loopIndex)) {
+						xx::CoutTN("move player failed. r = ", r);
+						return -5;
 					}
+					return 0;
 				}
-				break;
 			}
 
-			// ûλ. ûоֱӶϿ
-			PKG::CatchFish::Sits sit;
-			if (!scene.freeSits->TryPop(sit)) {
+			// ѡҪ scene ռ, Ҳ. ûλþֱӶϿ
+			auto&& player = service->SeatPlayer();
+			if (!player) {
 				xx::CoutTN("no more free sit: ", msg);
 				return -2;
 			}
 
-			// ( ģѴdb )
-			auto&& player = xx::Make<PKG::CatchFish::Player>();
-			xx::MakeTo(player->cannons);
-			player->scene = &scene;
-			player->id = ++::service->playerAutoId;
-			xx::Append(player->token, xx::Guid(true));
-			player->sit = sit;
-			player->pos = scene.cfg->sitPositons->At((int)sit);
-			player->coin = 100000;
-			xx::MakeTo(player->nickname, "player_" + std::to_string(player->id));
-			player->autoFire = false;
-			player->autoIncId = 0;
-			player->autoLock = false;
-			player->avatar_id = 0;
-			player->noMoney = false;
-			xx::MakeTo(player->weapons);
-
-			// ʼ̨
-			auto&& cannonCfgId = 0;
-			switch (cannonCfgId) {
-			case 0: {
-				auto&& cannonCfg = cfg.cannons->At(cannonCfgId);
-				auto&& cannon = xx::Make<PKG::CatchFish::Cannon>();
-				cannon->angle = float(cannonCfg->angle);
-				xx::MakeTo(cannon->bullets);
-				cannon->cfg = &*cannonCfg;
-				cannon->cfgId = cannonCfgId;
-				cannon->coin = 1;
-				cannon->id = (int)player->cannons->len;
-				cannon->player = &*player;
-				cannon->pos = cfg.sitPositons->At((int)sit);
-				cannon->quantity = cannonCfg->quantity;
-				cannon->scene = &scene;
-				cannon->fireCD = 0;
-				player->cannons->Add(cannon);
-				break;
-			}
-			// todo: more cannon types here
-			default:
-				xx::CoutTN("unbind recv unhandled cannon cfg id: ", msg);
-				return -3;
-			}
-
-			// ҷӦ
-			catchFish->players.Add(player);
-			scene.players->Add(player);
-			scene.frameEnters.Add(&*player);
-
 			// Ӱ
 			player_w = player;
 			player->peer = xx::As<Peer>(shared_from_this());
 
-			// ҽ֪ͨ֡ͬ·¼ϴ
-			{
-				auto&& enter = xx::Make<PKG::CatchFish::Events::Enter>();
-				enter->avatar_id = player->avatar_id;
-				enter->cannonCfgId = player->cannons->At(0)->cfgId;
-				enter->cannonCoin = player->cannons->At(0)->coin;
-				enter->coin = player->coin;
-				enter->nickname = player->nickname;
-				enter->noMoney = player->noMoney;
-				enter->playerId = player->id;
-				enter->sit = player->sit;
-				scene.frameEvents->events->Add(enter);
-			}
-
-			// óʱ
-			player->ResetTimeoutFrameNumber();
-
 			// ɹ˳
 			xx::CoutTN(GetIP(), " player enter. ", player);
 			break;
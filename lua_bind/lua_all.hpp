@@ -3,7 +3,17 @@
 #include "lua.hpp"
 #include "xx_uv_lua.h"
 
-#define USE_LUA_MEMPOOL 0
+// lua 内存分配方式. 0: 系统默认  1: Lua_MemPool( 2^n 分级 )  2: Lua_SlabPool( 16 字节步进分级 slab, 空 slab 归还系统 )
+#define USE_LUA_MEMPOOL 2
+
+#if USE_LUA_MEMPOOL
+#include "lua_mempool.h"
+#if USE_LUA_MEMPOOL == 2
+inline xx::Lua_SlabPool luaMP;
+#else
+inline xx::Lua_MemPool luaMP;
+#endif
+#endif
 
 
 // todo: 优化函数名和使用, 考虑参考 cocos lua 框架代码提供 return self 以便连写
@@ -142,17 +152,13 @@ inline int Lua_Main(lua_State* L)
 }
 
 
-#if USE_LUA_MEMPOOL
-#include "lua_mempool.h"
-inline xx::Lua_MemPool luaMP;
-#endif
 inline int Lua_Init()
 {
 #if USE_LUA_MEMPOOL
 	// 使用内存池创建 lua state ( 部分操作性能提升 40% )
 	auto&& L = gLua = lua_newstate([](void *ud, void *ptr, size_t osize, size_t nsize)
 	{
-		return ((xx::Lua_MemPool*)ud)->Realloc(ptr, nsize, osize);
+		return ((decltype(luaMP)*)ud)->Realloc(ptr, nsize, osize);
 	}
 	, & luaMP);
 #else
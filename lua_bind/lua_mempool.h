@@ -5,8 +5,12 @@
 #include <cstring>
 #include <array>
 #include <algorithm>
+#include <utility>
 #ifdef _WIN32
 #include <intrin.h>     // _BitScanReverse  64
+#include <windows.h>    // VirtualAlloc
+#else
+#include <sys/mman.h>   // mmap
 #endif
 
 namespace xx {
@@ -78,7 +82,7 @@ namespace xx {
 			if (originalSize >= newSize) return p;
 
 			auto np = Alloc(newSize);
-			memcpy(np, p, std::min(originalSize, dataLen));
+			memcpy(np, p, (std::min)(originalSize, dataLen));
 			Free(p);
 			return np;
 		}
@@ -102,4 +106,306 @@ namespace xx {
 #endif
 		}
 	};
+
+/*
+	size class slab allocator for lua_newstate. same usage as Lua_MemPool:
+
+	xx::Lua_SlabPool lsp;
+	...
+	auto L = lua_newstate([](void *ud, void *ptr, size_t osize, size_t nsize)
+	{
+		return ((xx::Lua_SlabPool*)ud)->Realloc(ptr, nsize, osize);
+	}, &lsp);
+
+	<= 512 bytes: 32 size classes in 16 byte steps. blocks are carved from 64k aligned page-backed slabs and carry no header
+	( lua passes osize on free / realloc, so the class is known; the owning slab is found by masking the address ).
+	slabs are carved lazily( untouched pages stay uncommitted ), and fully free slabs are returned to the OS except one spare per class.
+	> 512 bytes: plain malloc / realloc / free.
+*/
+	struct Lua_SlabPool {
+		static constexpr size_t step = 16;
+		static constexpr size_t maxSmallSize = 512;
+		static constexpr size_t numClasses = maxSmallSize / step;
+		static constexpr size_t slabSize = 64 * 1024;
+
+		struct Slab {
+			Slab* prev;							// avail list of its class
+			Slab* next;
+			Slab* allPrev;						// list of all slabs( for destructor )
+			Slab* allNext;
+			void* freeList;						// recycled blocks
+			char* bump;							// begin of the not yet carved area
+			char* end;
+			uint32_t used;						// blocks in use
+			uint32_t idx;						// size class
+		};
+		static constexpr size_t slabHeaderSize = (sizeof(Slab) + step - 1) / step * step;
+
+		struct Class {
+			Slab* avail = nullptr;				// slabs which have free room
+			Slab* spare = nullptr;				// one fully free slab kept to avoid map / unmap thrash
+			size_t numSlabs = 0;
+			size_t numBlocks = 0;				// blocks in use
+		};
+
+		std::array<Class, numClasses> classes;
+		Slab* all = nullptr;
+		size_t numSlabs = 0;
+		size_t largeCount = 0;
+		size_t largeBytes = 0;
+
+		// large blocks kept by a failed shrink into a small class( lua requires shrink never fail ).
+		// lua now passes a small size for them, so Free / Realloc look them up here first. value: real size
+		static constexpr size_t maxDemoted = 64;
+		std::array<std::pair<void*, size_t>, maxDemoted> demoted;
+		size_t numDemoted = 0;
+
+		Lua_SlabPool() = default;
+		Lua_SlabPool(Lua_SlabPool const&) = delete;
+		Lua_SlabPool& operator=(Lua_SlabPool const&) = delete;
+
+		~Lua_SlabPool() {
+			while (all) {
+				auto next = all->allNext;
+				UnmapSlab(all);
+				all = next;
+			}
+		}
+
+		// lua expects the old block untouched when growing fails, and shrinking never fails( lmem.c )
+		inline void* Realloc(void* p, size_t const& newSize, size_t const& dataLen) {
+			if (!p) return newSize ? Alloc(newSize) : nullptr;	// dataLen is lua's type tag here
+			if (!newSize) {
+				Free(p, dataLen);
+				return nullptr;
+			}
+			auto osize = dataLen;					// real size
+			auto di = numDemoted ? FindDemoted(p) : -1;
+			if (di >= 0) {
+				osize = demoted[di].second;
+			}
+			auto oidx = ClassIdx(osize);
+			auto nidx = ClassIdx(newSize);
+			if (oidx == numClasses && nidx == numClasses) {
+				if (auto np = realloc(p, newSize)) {
+					if (di >= 0) {
+						RemoveDemotedAt(di);
+					}
+					largeBytes = largeBytes - osize + newSize;
+					return np;
+				}
+				if (newSize > dataLen) return nullptr;
+				largeBytes = largeBytes - osize + newSize;	// shrink failed: keep the block. account as lua sees it
+				return p;
+			}
+			if (oidx == nidx) return p;
+			auto np = Alloc(newSize);
+			if (!np) {
+				if (newSize > dataLen) return nullptr;
+				// shrink failed: keep the block. a slab block stays in its slab( Free reads the class from slab ).
+				// a large block must be remembered, or lua's smaller size would route its Free to a slab
+				if (oidx == numClasses && di < 0 && !AddDemoted(p, osize)) return nullptr;
+				return p;
+			}
+			memcpy(np, p, (std::min)(dataLen, newSize));
+			Free(p, dataLen);
+			return np;
+		}
+
+		inline void* Alloc(size_t const& siz) {
+			assert(siz);
+			auto idx = ClassIdx(siz);
+			if (idx == numClasses) {
+				auto p = malloc(siz);
+				if (p) {
+					++largeCount;
+					largeBytes += siz;
+				}
+				return p;
+			}
+			auto&& c = classes[idx];
+			auto s = c.avail;
+			if (!s) {
+				if ((s = c.spare)) {
+					c.spare = nullptr;
+				}
+				else if (!(s = NewSlab(idx))) return nullptr;
+				Link(c, s);
+			}
+			void* p;
+			if (s->freeList) {
+				p = s->freeList;
+				s->freeList = *(void**)p;
+			}
+			else {
+				p = s->bump;
+				s->bump += (idx + 1) * step;
+			}
+			++s->used;
+			++c.numBlocks;
+			if (!s->freeList && s->bump == s->end) {
+				Unlink(c, s);
+			}
+			return p;
+		}
+
+		inline void Free(void* const& p, size_t const& siz) {
+			if (!p) return;
+			if (numDemoted) {
+				auto di = FindDemoted(p);
+				if (di >= 0) {
+					free(p);
+					--largeCount;
+					largeBytes -= demoted[di].second;
+					RemoveDemotedAt(di);
+					return;
+				}
+			}
+			if (ClassIdx(siz) == numClasses) {
+				free(p);
+				--largeCount;
+				largeBytes -= siz;
+				return;
+			}
+			auto s = (Slab*)((uintptr_t)p & ~(uintptr_t)(slabSize - 1));
+			auto idx = (size_t)s->idx;				// may be larger than siz's class after a failed shrink
+			assert(idx >= ClassIdx(siz) && s->used);
+			auto&& c = classes[idx];
+			if (!s->freeList && s->bump == s->end) {
+				Link(c, s);							// was full
+			}
+			*(void**)p = s->freeList;
+			s->freeList = p;
+			--c.numBlocks;
+			if (!--s->used) {
+				Unlink(c, s);
+				if (c.spare) {
+					DeleteSlab(s);
+				}
+				else {
+					s->freeList = nullptr;
+					s->bump = (char*)s + slabHeaderSize;
+					c.spare = s;
+				}
+			}
+		}
+
+		// bytes held in small blocks( rounded to class size )
+		inline size_t SmallBytes() const {
+			size_t r = 0;
+			for (size_t i = 0; i < numClasses; ++i) {
+				r += classes[i].numBlocks * (i + 1) * step;
+			}
+			return r;
+		}
+
+		inline static size_t ClassIdx(size_t const& siz) {
+			return siz > maxSmallSize ? numClasses : (siz - 1) / step;
+		}
+
+	protected:
+		inline int FindDemoted(void* const& p) const {
+			for (size_t i = 0; i < numDemoted; ++i) {
+				if (demoted[i].first == p) return (int)i;
+			}
+			return -1;
+		}
+
+		inline bool AddDemoted(void* const& p, size_t const& siz) {
+			if (numDemoted == maxDemoted) return false;
+			demoted[numDemoted++] = std::make_pair(p, siz);
+			return true;
+		}
+
+		inline void RemoveDemotedAt(int const& i) {
+			demoted[i] = demoted[--numDemoted];
+		}
+
+		inline Slab* NewSlab(size_t const& idx) {
+			auto s = MapSlab();
+			if (!s) return nullptr;
+			auto bs = (idx + 1) * step;
+			s->prev = s->next = nullptr;
+			s->freeList = nullptr;
+			s->bump = (char*)s + slabHeaderSize;
+			s->end = s->bump + (slabSize - slabHeaderSize) / bs * bs;
+			s->used = 0;
+			s->idx = (uint32_t)idx;
+			s->allPrev = nullptr;
+			s->allNext = all;
+			if (all) {
+				all->allPrev = s;
+			}
+			all = s;
+			++numSlabs;
+			++classes[idx].numSlabs;
+			return s;
+		}
+
+		inline void DeleteSlab(Slab* const& s) {
+			if (s->allPrev) {
+				s->allPrev->allNext = s->allNext;
+			}
+			else {
+				all = s->allNext;
+			}
+			if (s->allNext) {
+				s->allNext->allPrev = s->allPrev;
+			}
+			--numSlabs;
+			--classes[s->idx].numSlabs;
+			UnmapSlab(s);
+		}
+
+		inline static void Link(Class& c, Slab* const& s) {
+			s->prev = nullptr;
+			s->next = c.avail;
+			if (c.avail) {
+				c.avail->prev = s;
+			}
+			c.avail = s;
+		}
+
+		inline static void Unlink(Class& c, Slab* const& s) {
+			if (s->prev) {
+				s->prev->next = s->next;
+			}
+			else {
+				c.avail = s->next;
+			}
+			if (s->next) {
+				s->next->prev = s->prev;
+			}
+			s->prev = s->next = nullptr;
+		}
+
+		// slabSize aligned, slabSize bytes, straight from the OS
+		inline static Slab* MapSlab() {
+#ifdef _WIN32
+			// allocation granularity on windows is 64k
+			static_assert(slabSize == 64 * 1024, "");
+			return (Slab*)VirtualAlloc(nullptr, slabSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+			// map 2x then trim the unaligned head & tail
+			auto m = (char*)mmap(nullptr, slabSize * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (m == (char*)MAP_FAILED) return nullptr;
+			auto p = (char*)(((uintptr_t)m + slabSize - 1) & ~(uintptr_t)(slabSize - 1));
+			if (p != m) {
+				munmap(m, p - m);
+			}
+			if (auto tail = m + slabSize * 2 - (p + slabSize)) {
+				munmap(p + slabSize, tail);
+			}
+			return (Slab*)p;
+#endif
+		}
+
+		inline static void UnmapSlab(Slab* const& s) {
+#ifdef _WIN32
+			VirtualFree(s, 0, MEM_RELEASE);
+#else
+			munmap(s, slabSize);
+#endif
+		}
+	};
 }
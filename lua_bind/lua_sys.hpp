@@ -12,6 +12,20 @@ inline void Lua_Register_sys(lua_State* const& L)
 		return Lua_Pushs(L, r);
 	});
 
+#if USE_LUA_MEMPOOL == 2
+	// 返回 lua 内存池统计信息表: slabs( 从系统申请的 slab 个数 ), slabBytes, smallBytes( 小块占用 ), largeCount, largeBytes( 大块直接 malloc )
+	Lua_NewFunc(L, "GetMemPoolStats", [](lua_State* L)
+	{
+		lua_createtable(L, 0, 5);
+		lua_pushstring(L, "slabs");			lua_pushinteger(L, (lua_Integer)luaMP.numSlabs);								lua_rawset(L, -3);
+		lua_pushstring(L, "slabBytes");		lua_pushinteger(L, (lua_Integer)(luaMP.numSlabs * xx::Lua_SlabPool::slabSize));	lua_rawset(L, -3);
+		lua_pushstring(L, "smallBytes");	lua_pushinteger(L, (lua_Integer)luaMP.SmallBytes());							lua_rawset(L, -3);
+		lua_pushstring(L, "largeCount");	lua_pushinteger(L, (lua_Integer)luaMP.largeCount);								lua_rawset(L, -3);
+		lua_pushstring(L, "largeBytes");	lua_pushinteger(L, (lua_Integer)luaMP.largeBytes);								lua_rawset(L, -3);
+		return 1;
+	});
+#endif
+
 	lua_pop(L, 1);
 	assert(lua_gettop(L) == 0);
 }
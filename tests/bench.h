@@ -0,0 +1,27 @@
+﻿#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/resource.h>
+
+// 测试 & 基准 共用的小工具
+
+// 条件不成立就输出位置并以 1 退出( 不受 NDEBUG 影响 )
+#define CHECK(cond) do { if (!(cond)) { printf("CHECK failed: %s at %s:%d\n", #cond, __FILE__, __LINE__); fflush(stdout); exit(1); } } while (0)
+
+// 单调时钟 纳秒
+inline int64_t NowNS() noexcept {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 本进程已用 cpu 时间( user + sys ) 纳秒
+inline int64_t CpuNS() noexcept {
+	rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	return (int64_t(ru.ru_utime.tv_sec) + ru.ru_stime.tv_sec) * 1000000000 + (int64_t(ru.ru_utime.tv_usec) + ru.ru_stime.tv_usec) * 1000;
+}
+
+// 取命令行第 i 个参数为整数. 没有就返回 def
+inline int ArgInt(int const& argc, char** const& argv, int const& i, int const& def) noexcept {
+	return i < argc ? atoi(argv[i]) : def;
+}
@@ -0,0 +1,68 @@
+﻿// 整个 PKG::CatchFish::Scene 对象图的 WriteRoot / ReadRoot 耗时( 同 EnterSuccess 下发的主体 ), 以 ns/object 输出
+// object 数取 WriteRoot 期间 ptrs 记录的 指针数( 对象 + 字符串 )
+// 用法: bench_bbuffer_scene [预跑帧数 = 3000] [轮数 = 1000]
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <limits>
+
+int main(int argc, char** argv) {
+	auto&& numFrames = ArgInt(argc, argv, 1, 3000);
+	auto&& numRounds = ArgInt(argc, argv, 2, 1000);
+
+	auto&& cfg = LoadTestConfig();
+	xx::Uv uv;
+	Service service(uv, cfg, true);
+
+	// 放 4 个玩家进同一场景 一直开火, 预跑若干帧, 让 鱼, 子弹, 预约 等攒起来
+	std::vector<TestClient> clients;
+	for (int i = 0; i < 4; ++i) {
+		auto&& p = service.SeatPlayer();
+		CHECK(p);
+		p->coin = std::numeric_limits<int>::max();		// 打不完
+		clients.emplace_back(&*p);
+	}
+	auto&& scene = service.catchFish->scenes[0];
+	xx::Random rnd(1);
+	for (int i = 0; i < numFrames; ++i) {
+		CHECK(!service.catchFish->Update());
+		for (auto&& c : clients) {
+			c.Hits();
+			(void)c.Fire(float(rnd.Next(0, 628)) / 100);
+		}
+	}
+	CHECK(service.catchFish->players.len == clients.size());		// 都没被踢
+
+	xx::BBuffer bb;
+	bb.offsetRoot = bb.len;
+	bb.Write(scene);
+	auto numObjs = bb.ptrs.count;
+	bb.ptrs.Clear();
+	bb.Clear();
+	bb.offset = 0;
+
+	// 预热: 让 bb 的 buf, ptrs, readIdxs 扩容到位
+	PKG::CatchFish::Scene_s s2;
+	bb.WriteRoot(scene);
+	CHECK(!bb.ReadRoot(s2));
+	CHECK(s2 && s2->fishs->len == scene->fishs->len && s2->frameNumber == scene->frameNumber);
+
+	int64_t writeNS = 0, readNS = 0;
+	for (int i = 0; i < numRounds; ++i) {
+		bb.Clear();
+		bb.offset = 0;
+		auto t = NowNS();
+		bb.WriteRoot(scene);
+		writeNS += NowNS() - t;
+
+		s2.reset();
+		t = NowNS();
+		CHECK(!bb.ReadRoot(s2));
+		readNS += NowNS() - t;
+	}
+	auto&& n = double(numObjs) * numRounds;
+	printf("scene: fishs = %zu, borns = %zu, items = %zu, objects = %zu, bytes = %zu\n"
+		, scene->fishs->len, scene->borns->len, scene->items->len, numObjs, bb.len);
+	printf("WriteRoot: %8.1f ns/object\n", writeNS / n);
+	printf("ReadRoot : %8.1f ns/object\n", readNS / n);
+	return 0;
+}
@@ -0,0 +1,104 @@
+﻿// 子弹 vs 鱼 碰撞检测: 全量倒序扫描 与 xx::SpaceGrid 宽相( 每帧重建, 子弹只查所在格子 ) 对比. 窄相都用 Fish::HitCheck
+// 鱼 & 子弹 取自 cfg.bin 的配置, 每帧随机摆放在设计区域内( 摆放不计时 ). 两种方式选中的鱼必须一致
+// 用法: bench_fish_grid [鱼数 = 300] [子弹数 = 200] [帧数 = 2000]
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <vector>
+
+int main(int argc, char** argv) {
+	auto&& numFishs = ArgInt(argc, argv, 1, 300);
+	auto&& numBullets = ArgInt(argc, argv, 2, 200);
+	auto&& numFrames = ArgInt(argc, argv, 3, 2000);
+
+	auto&& cfg = LoadTestConfig();
+	xx::Random rnd(1);
+	auto&& randPos = [&] {
+		return xx::Pos{ float(rnd.Next((int)designSize.x)) - designSize_2.x, float(rnd.Next((int)designSize.y)) - designSize_2.y };
+	};
+
+	// 同 Scene::InitCascade / BuildFishGrid
+	float margin = 0;
+	for (auto&& c : *cfg->cannons) {
+		auto&& br = c->radius * c->scale;
+		if (br > margin) {
+			margin = br;
+		}
+	}
+	xx::SpaceGrid grid;
+	grid.Init(designSize, 80);
+
+	std::vector<PKG::CatchFish::Fish_s> fs;
+	for (int i = 0; i < numFishs; ++i) {
+		auto&& f = xx::Make<PKG::CatchFish::Fish>();
+		f->cfg = &*cfg->fishs->At(i % (int)cfg->fishs->len);
+		f->scale = 1;
+		f->indexAtContainer = i;
+		fs.push_back(std::move(f));
+	}
+	std::vector<PKG::CatchFish::Bullet_s> bs;
+	for (int i = 0; i < numBullets; ++i) {
+		auto&& b = xx::Make<PKG::CatchFish::Bullet>();
+		b->cfg = &*cfg->cannons->At(0);
+		bs.push_back(std::move(b));
+	}
+
+	std::vector<int> hitsScan(numBullets), hitsGrid(numBullets);
+	int64_t scanNS = 0, gridNS = 0, numHits = 0, numCandidates = 0;
+	for (int frame = 0; frame < numFrames; ++frame) {
+		for (auto&& f : fs) {
+			f->pos = randPos();
+			f->angle = float(rnd.Next(0, 628)) / 100;
+			f->spriteFrameIndex = rnd.Next((int)f->cfg->moveFrames->len);
+		}
+		for (auto&& b : bs) {
+			b->pos = randPos();
+		}
+
+		// 全量扫描( 原 Bullet::Update 的写法 )
+		auto t = NowNS();
+		for (int i = 0; i < numBullets; ++i) {
+			hitsScan[i] = -1;
+			for (int j = numFishs - 1; j >= 0; --j) {
+				if (fs[j]->HitCheck(&*bs[i])) {
+					hitsScan[i] = j;
+					break;
+				}
+			}
+		}
+		scanNS += NowNS() - t;
+
+		// 网格: 重建 + 查询
+		t = NowNS();
+		grid.Clear();
+		for (int j = 0; j < numFishs; ++j) {
+			auto&& f = fs[j];
+			auto&& r = f->cfg->maxDetectRadius > 0 ? f->cfg->maxDetectRadius * f->cfg->scale * f->scale + margin : 0.0f;
+			grid.Add(j, f->pos, r);
+		}
+		grid.Build();
+		for (int i = 0; i < numBullets; ++i) {
+			hitsGrid[i] = -1;
+			int n = 0;
+			auto&& idxs = grid.At(bs[i]->pos, n);
+			numCandidates += n;
+			for (int k = n - 1; k >= 0; --k) {
+				if (fs[idxs[k]]->HitCheck(&*bs[i])) {
+					hitsGrid[i] = idxs[k];
+					break;
+				}
+			}
+		}
+		gridNS += NowNS() - t;
+
+		for (int i = 0; i < numBullets; ++i) {
+			CHECK(hitsScan[i] == hitsGrid[i]);
+			numHits += hitsScan[i] != -1;
+		}
+	}
+
+	printf("fishs = %d, bullets = %d, frames = %d, hits = %lld, grid candidates / bullet = %.1f\n"
+		, numFishs, numBullets, numFrames, (long long)numHits, double(numCandidates) / numBullets / numFrames);
+	printf("scan: %8.1f us/frame\n", scanNS / 1000.0 / numFrames);
+	printf("grid: %8.1f us/frame\n", gridNS / 1000.0 / numFrames);
+	return 0;
+}
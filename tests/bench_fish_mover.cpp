@@ -0,0 +1,91 @@
+﻿// 直线鱼移动: 逐条 虚函数 Fish::Update( 旧路径 ) vs Scene::FishMover( SoA 镜像批量 Move + 遍历时 Pull 回写 + Sweep )
+// 两组鱼 初始数据相同, 出界就在同一位置重生, 保持数量不变. 每帧校验两边 坐标 & 帧下标 逐位一致( 校验不计时 )
+// 用法: bench_fish_mover 鱼数 [鱼数...] 帧数. 输出 ns/fish/frame
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <cstring>
+#include <vector>
+
+static PKG::CatchFish::Configs::Config_s cfg;
+
+// 按 seed 确定性地摆放: 屏幕内随机位置, 随机方向, 速度 1 ~ 5
+static void Spawn(PKG::CatchFish::Fish& f, uint32_t seed) {
+	auto&& next = [&] {
+		seed = seed * 1103515245u + 12345u;
+		return (seed >> 8) & 0xFFFF;
+	};
+	f.cfg = &*cfg->fishs->At(int(next() % cfg->fishs->len));
+	f.scale = 1;
+	f.speedScale = 1;
+	f.frameRatio = 1;
+	f.pos = { float(next() % (int)designSize.x) - designSize_2.x, float(next() % (int)designSize.y) - designSize_2.y };
+	f.moveInc = xx::Rotate(xx::Pos{ 1 + float(next() % 400) / 100, 0 }, float(next() % 628) / 100);
+	f.spriteFrameIndex = int(next() % f.cfg->moveFrames->len);
+}
+
+static bool Same(PKG::CatchFish::Fish const& a, PKG::CatchFish::Fish const& b) {
+	return !memcmp(&a.pos, &b.pos, sizeof(a.pos)) && a.spriteFrameIndex == b.spriteFrameIndex;
+}
+
+static void Bench(int const& numFishs, int const& numFrames) {
+	std::vector<PKG::CatchFish::Fish_s> as, bs;
+	PKG::CatchFish::Scene::FishMover mover;
+	for (int i = 0; i < numFishs; ++i) {
+		as.push_back(xx::Make<PKG::CatchFish::Fish>());
+		bs.push_back(xx::Make<PKG::CatchFish::Fish>());
+		Spawn(*as[i], i);
+		Spawn(*bs[i], i);
+		mover.TryAdd(&*bs[i], 0);
+	}
+	CHECK((int)mover.fishs.len == numFishs);
+
+	int64_t scalarNS = 0, moverNS = 0, numRespawns = 0;
+	for (int frameNumber = 1; frameNumber <= numFrames; ++frameNumber) {
+		// 旧: 逐条虚函数
+		auto t = NowNS();
+		for (int i = numFishs - 1; i >= 0; --i) {
+			if (as[i]->Update(frameNumber)) {
+				Spawn(*as[i], uint32_t(frameNumber * 7919 + i));
+				++numRespawns;
+			}
+		}
+		scalarNS += NowNS() - t;
+
+		// 新: 同 Scene::Update 的用法
+		t = NowNS();
+		mover.Move();
+		for (int i = numFishs - 1; i >= 0; --i) {
+			auto&& f = &*bs[i];
+			if (mover.Pull(f, frameNumber)) {
+				Spawn(*f, uint32_t(frameNumber * 7919 + i));
+				mover.TryAdd(f, frameNumber);
+			}
+		}
+		mover.Sweep(frameNumber);
+		moverNS += NowNS() - t;
+
+		for (int i = 0; i < numFishs; ++i) {
+			CHECK(Same(*as[i], *bs[i]));
+		}
+		CHECK((int)mover.fishs.len == numFishs);
+	}
+	auto&& n = double(numFishs) * numFrames;
+	printf("fishs = %5d  respawns = %7lld  virtual Update = %5.2f ns/fish/frame  FishMover = %5.2f ns/fish/frame\n"
+		, numFishs, (long long)numRespawns, scalarNS / n, moverNS / n);
+}
+
+int main(int argc, char** argv) {
+	cfg = LoadTestConfig();
+	std::vector<int> ns;
+	for (int i = 1; i + 1 < argc; ++i) {
+		ns.push_back(atoi(argv[i]));
+	}
+	if (ns.empty()) {
+		ns = { 1000, 5000 };
+	}
+	auto numFrames = argc > 1 ? atoi(argv[argc - 1]) : 3000;
+	for (auto&& n : ns) {
+		Bench(n, numFrames);
+	}
+	return 0;
+}
@@ -0,0 +1,112 @@
+﻿// Hit 风暴下的 id 定位: 旧写法( 倒序扫容器比 id ) vs 索引( Scene::FindFish, Cannon::bulletById, CatchFish::FindPlayer )
+// 每个 Hit 依次定位 子弹( 所属炮台中 ), 鱼( 场景中, 一半 id 不存在 ), 玩家( 结算时 ). 输出 ns/hit
+// 用法: bench_id_lookup 鱼数 [鱼数...] 子弹数 玩家数
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <algorithm>
+#include <vector>
+
+struct HitIds {
+	int fishId, bulletId, playerId;
+};
+
+int main(int argc, char** argv) {
+	std::vector<int> ns;
+	for (int i = 1; i + 2 < argc; ++i) {
+		ns.push_back(atoi(argv[i]));
+	}
+	if (ns.empty()) {
+		ns = { 100, 300, 1000 };
+	}
+	auto numBullets = argc > 2 ? atoi(argv[argc - 2]) : 100;
+	auto numPlayers = argc > 2 ? atoi(argv[argc - 1]) : 400;
+	auto numHits = 1000000;
+
+	auto&& cfg = LoadTestConfig();
+	xx::Uv uv;
+	Service service(uv, cfg, true);
+	auto&& catchFish = *service.catchFish;
+	xx::Random rnd(1);
+
+	// 玩家: 每场景 4 个, 新建的场景会追加到 scenes
+	for (int i = 0; i < numPlayers; ++i) {
+		CHECK(service.SeatPlayer());
+	}
+	auto&& player = *catchFish.players[0];
+	auto&& scene = *player.scene;
+
+	// 子弹: 直接放进首个玩家的炮台( 同 Cannon::Fire 的建索引方式 )
+	auto&& cannon = *player.cannons->At(0);
+	for (int i = 1; i <= numBullets; ++i) {
+		auto&& b = xx::Make<PKG::CatchFish::Bullet>();
+		b->id = i;
+		b->indexAtContainer = (int)cannon.bullets->len;
+		cannon.bullets->Add(b);
+		cannon.bulletById.Add(b->id, &*b);
+	}
+
+	for (auto&& numFishs : ns) {
+		// 鱼: id 1 ~ numFishs, 容器中乱序( 同 交换删除 之后的样子 )
+		while (scene.fishs->len) {
+			scene.RemoveFishAt(scene.fishs->len - 1);
+		}
+		std::vector<int> ids;
+		for (int i = 1; i <= numFishs; ++i) {
+			ids.push_back(i);
+		}
+		for (int i = numFishs - 1; i > 0; --i) {
+			std::swap(ids[i], ids[rnd.Next(i + 1)]);
+		}
+		for (auto&& id : ids) {
+			auto&& f = xx::Make<PKG::CatchFish::Fish>();
+			f->id = id;
+			scene.AddFish(f);
+		}
+
+		std::vector<HitIds> hits(numHits);
+		for (auto&& h : hits) {
+			h.fishId = rnd.Next(1, numFishs * 2 + 1);
+			h.bulletId = rnd.Next(1, numBullets + 1);
+			h.playerId = catchFish.players[rnd.Next((int)catchFish.players.len)]->id;
+		}
+
+		// 旧: 倒序扫
+		int64_t sum1 = 0;
+		auto t = NowNS();
+		for (auto&& h : hits) {
+			auto&& bs = *cannon.bullets;
+			size_t i = bs.len - 1;
+			for (; i != -1; --i) {
+				if (bs[i]->id == h.bulletId) break;
+			}
+			auto&& fs = *scene.fishs;
+			size_t j = fs.len - 1;
+			for (; j != -1; --j) {
+				if (fs[j]->id == h.fishId) break;
+			}
+			auto&& ps = catchFish.players;
+			size_t k = ps.len - 1;
+			for (; k != -1; --k) {
+				if (ps[k]->id == h.playerId) break;
+			}
+			sum1 += (int64_t)i + (j == -1 ? 0 : fs[j]->id) + ps[k]->id;
+		}
+		auto scanNS = NowNS() - t;
+
+		// 新: 索引
+		int64_t sum2 = 0;
+		t = NowNS();
+		for (auto&& h : hits) {
+			auto&& bidx = cannon.bulletById.Find(h.bulletId);
+			auto&& f = scene.FindFish(h.fishId);
+			auto&& p = catchFish.FindPlayer(h.playerId);
+			sum2 += (int64_t)cannon.bulletById.ValueAt(bidx)->indexAtContainer + (f ? f->id : 0) + p->id;
+		}
+		auto dictNS = NowNS() - t;
+
+		CHECK(sum1 == sum2);
+		printf("fishs = %5d  bullets = %4d  players = %4zu  scan = %7.1f ns/hit  index = %5.1f ns/hit\n"
+			, numFishs, numBullets, catchFish.players.len, double(scanNS) / numHits, double(dictNS) / numHits);
+	}
+	return 0;
+}
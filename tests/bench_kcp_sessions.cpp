@@ -0,0 +1,107 @@
+﻿// kcp 会话数 扩展性: 会话按 ikcp_check 挂 Uv::wheel( 只处理到期的 ) vs 每 10ms 扫描全部会话调 Update( 旧 UvListenerKcp::Update 的做法 )
+// 一条真实 kcp 连接在跑 echo, 校验调度正确, 其余为空闲会话
+// 用法: bench_kcp_sessions 会话数 [会话数...] 秒数. 输出 loop 的 cpu 占用 及 echo 次数
+#include "xx_uv.h"
+#include "bench.h"
+#include <vector>
+
+static void Run(int const& n, int const& seconds, bool const& scan, double& cpu, int& echoes) {
+	xx::Uv uv;
+	auto&& listener = xx::Make<xx::UvListener>(uv, "127.0.0.1", 23460, 1);
+	auto&& udp = listener->kcpListener->udp;
+	CHECK(udp);
+
+	// 空闲会话: 同 UvListenerKcp::Unpack 握手成功后的创建过程. 对端地址为本机 discard 端口
+	sockaddr_in6 addr;
+	CHECK(!uv_ip4_addr("127.0.0.1", 9, (sockaddr_in*)&addr));
+	std::vector<std::shared_ptr<xx::UvKcpPeerBase>> sessions;
+	for (int i = 0; i < n; ++i) {
+		auto&& s = xx::Make<xx::UvKcpPeerBase>(uv);
+		s->udp = udp;
+		s->conv = 0x10000000 + i;
+		s->createMS = xx::NowSteadyEpochMS();
+		s->addr = addr;
+		CHECK(!s->InitKcp());
+		udp->peers[s->conv] = s;
+		sessions.push_back(s);
+	}
+
+	// 旧做法: 每 10ms 遍历全部会话
+	xx::UvTimer_s scanner;
+	if (scan) {
+		xx::MakeTo(scanner, uv, 10, 10, [&] {
+			auto&& nowMS = xx::NowSteadyEpochMS();
+			for (auto&& kv : udp->peers) {
+				if (auto&& s = kv.value.lock()) {
+					s->Update(nowMS);
+				}
+			}
+		});
+	}
+
+	// echo
+	echoes = 0;
+	xx::UvPeer_s server;
+	listener->onAccept = [&](xx::UvPeer_s p) {
+		server = p;
+		auto pp = p.get();
+		p->onReceivePush = [pp](xx::Object_s&& o) {
+			return pp->SendPush(o);
+		};
+	};
+	auto&& msg = xx::Make<xx::BBuffer>();
+	msg->Write(1, 2, 3, 4);
+	xx::UvPeer_s client;
+	auto&& dialer = xx::Make<xx::UvDialer>(uv);
+	dialer->onAccept = [&](xx::UvPeer_s p) {
+		CHECK(p);
+		client = p;
+		p->onReceivePush = [&](xx::Object_s&& o) {
+			++echoes;
+			return client->SendPush(msg);
+		};
+		p->SendPush(msg);
+	};
+	CHECK(!dialer->Dial("127.0.0.1", 23460, 2000));
+
+	// 等连上再计时
+	xx::UvTimer_s stop;
+	int64_t t = 0, c = 0;
+	xx::MakeTo(stop, uv, 200, 0, [&] {
+		t = NowNS();
+		c = CpuNS();
+		echoes = 0;
+		xx::MakeTo(stop, uv, uint64_t(seconds) * 1000, 0, [&] {
+			uv.Stop();
+		});
+	});
+	uv.Run();
+	cpu = double(CpuNS() - c) * 100 / double(NowNS() - t);
+	CHECK(client && !client->Disposed());
+	client->Dispose(1);
+	server->Dispose(1);
+	for (auto&& s : sessions) {
+		s->Dispose(0);
+	}
+	listener->Dispose(1);
+}
+
+int main(int argc, char** argv) {
+	std::vector<int> ns;
+	for (int i = 1; i + 1 < argc; ++i) {
+		ns.push_back(atoi(argv[i]));
+	}
+	if (ns.empty()) {
+		ns = { 1000, 10000, 50000 };
+	}
+	auto seconds = argc > 1 ? atoi(argv[argc - 1]) : 2;
+	for (auto&& n : ns) {
+		double cw, cs;
+		int ew, es;
+		Run(n, seconds, false, cw, ew);
+		Run(n, seconds, true, cs, es);
+		CHECK(ew > 0 && es > 0);
+		printf("idle sessions = %6d    wheel: cpu = %6.2f%% echo = %7d    scan: cpu = %6.2f%% echo = %7d\n", n, cw, ew, cs, es);
+	}
+	return 0;
+}
@@ -0,0 +1,71 @@
+﻿// 单 loop( 单核 )承载能力: N 个满座( 4 人 )场景 + 同样多的空场景, 玩家持续 开火 / 上报 Hit, 统计 CatchFish::Update 每帧耗时, 折算 60 FPS 下 每核场景数
+// 玩家无连接, 不含网络下发; 空场景不应增加开销. Scene 每 120 帧往 stdout 打一次玩家 coin, 故结果写到 stderr( 可 > /dev/null 看结果 )
+// 用法: bench_scene_load [场景数 = 1000] [帧数 = 600]
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <limits>
+#include <vector>
+
+int main(int argc, char** argv) {
+	auto&& numScenes = ArgInt(argc, argv, 1, 1000);
+	auto&& numFrames = ArgInt(argc, argv, 2, 600);
+
+	auto&& cfg = LoadTestConfig();
+	xx::Uv uv;
+	Service service(uv, cfg, true);
+	auto&& catchFish = *service.catchFish;
+	catchFish.maxScenes = numScenes * 2;
+
+	// 先建 N 个场景由 Match 坐满, 再补建 N 个空场景
+	for (int i = 0; i < numScenes; ++i) {
+		CHECK(catchFish.CreateScene());
+	}
+	std::vector<TestClient> clients;
+	for (int i = 0; i < numScenes * 4; ++i) {
+		auto&& p = service.SeatPlayer();
+		CHECK(p);
+		p->coin = std::numeric_limits<int>::max() / 2;
+		clients.emplace_back(&*p);
+	}
+	while ((int)catchFish.scenes.len < numScenes * 2) {
+		CHECK(catchFish.CreateScene());
+	}
+	int numActive = 0;
+	for (auto&& s : catchFish.scenes) {
+		numActive += s->players->len ? 1 : 0;
+	}
+	CHECK(numActive == numScenes);
+
+	xx::Random rnd(1);
+	int64_t inputNS = 0, updateNS = 0, maxNS = 0;
+	for (int f = 0; f < numFrames; ++f) {
+		auto t = NowNS();
+		for (auto&& c : clients) {
+			c.Hits();
+			(void)c.Fire(float(rnd.Next(0, 628)) / 100);
+		}
+		auto t2 = NowNS();
+		CHECK(!catchFish.Update());
+		auto d = NowNS() - t2;
+		inputNS += t2 - t;
+		updateNS += d;
+		maxNS = std::max(maxNS, d);
+	}
+	CHECK(catchFish.players.len == clients.size());
+
+	size_t numFishs = 0, numBullets = 0;
+	for (auto&& s : catchFish.scenes) {
+		numFishs += s->fishs->len;
+	}
+	for (auto&& c : clients) {
+		for (auto&& cannon : *c.player->cannons) {
+			numBullets += cannon->bullets->len;
+		}
+	}
+	auto&& avgMS = double(updateNS) / numFrames / 1000000;
+	fprintf(stderr, "scenes = %d ( + %d empty )  players = %zu  fishs = %zu  bullets = %zu\n"
+		, numActive, (int)catchFish.scenes.len - numActive, catchFish.players.len, numFishs, numBullets);
+	fprintf(stderr, "Update = %.3f ms/frame ( max %.3f )  input = %.3f ms/frame  60 FPS: %.0f scenes/core\n"
+		, avgMS, maxNS / 1000000.0, double(inputNS) / numFrames / 1000000, numActive * (1000.0 / 60) / avgMS);
+	return 0;
+}
@@ -0,0 +1,68 @@
+﻿// 关卡切换开销: 旧写法( 从 cfg->stageBufs 反序列化 + InitCascade ) vs Scene::SwitchStage( 复用缓存实例, 按模板还原 )
+// 再空场景连续 Update 若干帧, 对比 切关帧 与 普通帧 的耗时( 看尖峰 )
+// 用法: bench_stage_switch [切换次数 = 2000] [Update 帧数 = 0( 0: 跑满一轮全部关卡 )]
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <algorithm>
+#include <vector>
+
+int main(int argc, char** argv) {
+	auto&& numSwitchs = ArgInt(argc, argv, 1, 2000);
+	auto&& numFrames = ArgInt(argc, argv, 2, 0);
+
+	auto&& cfg = LoadTestConfig();
+	xx::Uv uv;
+	Service service(uv, cfg, true);
+	auto&& scene = *service.catchFish->scenes[0];
+	auto&& numStages = (int)cfg->stageBufs.len;
+	CHECK(numStages > 0 && (int)scene.stages.len == numStages);
+
+	// 旧: 每次切换都重建
+	xx::BBuffer bb;
+	PKG::CatchFish::Stages::Stage_s tmp;
+	auto t = NowNS();
+	for (int i = 0; i < numSwitchs; ++i) {
+		auto&& src = cfg->stageBufs[i % numStages];
+		bb.Reset(src.buf, src.len);
+		CHECK(!bb.ReadRoot(tmp));
+		bb.Reset();
+		CHECK(!tmp->InitCascade(&scene));
+	}
+	auto readNS = NowNS() - t;
+
+	// 新
+	t = NowNS();
+	for (int i = 0; i < numSwitchs; ++i) {
+		scene.SwitchStage(i % numStages);
+	}
+	auto switchNS = NowNS() - t;
+	CHECK(scene.stage == scene.stages[(numSwitchs - 1) % numStages]);
+	printf("stages = %d  ReadRoot + InitCascade = %8.1f ns/switch  SwitchStage = %6.1f ns/switch\n"
+		, numStages, double(readNS) / numSwitchs, double(switchNS) / numSwitchs);
+
+	// 逐帧: 从关卡 0 开始, 默认跑满一轮
+	scene.SwitchStage(0);
+	if (!numFrames) {
+		for (auto&& s : *cfg->stages) {
+			numFrames += s->cfg_endTicks + 1;
+		}
+	}
+	std::vector<int64_t> normals, switchs;
+	for (int i = 0; i < numFrames; ++i) {
+		auto&& s = &*scene.stage;
+		t = NowNS();
+		CHECK(!scene.Update());
+		auto&& d = NowNS() - t;
+		(s == &*scene.stage ? normals : switchs).push_back(d);
+	}
+	CHECK(!normals.empty());
+	std::sort(normals.begin(), normals.end());
+	int64_t maxSwitch = 0;
+	for (auto&& d : switchs) {
+		maxSwitch = std::max(maxSwitch, d);
+	}
+	printf("frames = %d  normal p50 = %6.1f us  p99 = %6.1f us  max = %6.1f us  switch frames = %zu  max = %6.1f us\n"
+		, numFrames, normals[normals.size() / 2] / 1000.0, normals[normals.size() * 99 / 100] / 1000.0
+		, normals.back() / 1000.0, switchs.size(), maxSwitch / 1000.0);
+	return 0;
+}
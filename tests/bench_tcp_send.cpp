@@ -0,0 +1,123 @@
+﻿// tcp 发送路径的内存分配次数: SendPush( 每包序列化 ) 与 SendSharedPush( 序列化一次 发给多个 peer )
+// 每 1ms 给每个 peer 发 burst 个包, 收齐后统计 发送侧 uv.sendPool 的 malloc 次数 以及 operator new 次数( 旧路径 每包至少一次 malloc + 一次 free )
+// 同一 loop 中在途的块超过 UvSendPool::maxCount 时 多出的部分会回退到 malloc, 故分别以 小 burst 与 大 burst 跑
+// 用法: bench_tcp_send [包数 = 100000] [peer 数 = 4]
+#include "xx_uv.h"
+#include "bench.h"
+#include <csignal>
+#include <new>
+#include <vector>
+
+static size_t numNews = 0;
+void* operator new(size_t n) {
+	++numNews;
+	if (auto p = malloc(n)) return p;
+	throw std::bad_alloc();
+}
+void* operator new(size_t n, std::nothrow_t const&) noexcept {
+	++numNews;
+	return malloc(n);
+}
+void operator delete(void* p) noexcept {
+	free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+	free(p);
+}
+
+// shared: false 每个 peer 各自 SendPush. true 每轮 MakeSharedPackage 一次再 SendSharedPush 给所有 peer
+static void Run(int const& numPkgs, int const& numPeers, int const& burst, bool const& shared) {
+	xx::Uv uv;
+	auto&& listener = xx::Make<xx::UvListener>(uv, "127.0.0.1", 23461, 0);
+	std::vector<xx::UvPeer_s> servers, clients;
+	std::vector<xx::UvDialer_s> dialers;
+	int received = 0;
+	size_t mallocs = 0, news = 0;				// 只统计 发送侧
+	int64_t t = 0;
+
+	auto&& msg = xx::Make<xx::BBuffer>();
+	for (int i = 0; i < 16; ++i) {
+		msg->Write(i);
+	}
+	xx::UvTimer_s sender;
+	int sent = 0;
+	auto&& Start = [&] {
+		t = NowNS();
+		xx::MakeTo(sender, uv, 0, 1, [&] {
+			auto m = uv.sendPool.mallocCount;
+			auto n = numNews;
+			for (int i = 0; i < burst && sent < numPkgs; ++i) {
+				if (shared) {
+					auto&& pkg = xx::UvPeer::MakeSharedPackage(msg);
+					for (auto&& s : servers) {
+						CHECK(!s->SendSharedPush(pkg));
+					}
+				}
+				else {
+					for (auto&& s : servers) {
+						CHECK(!s->SendPush(msg));
+					}
+				}
+				++sent;
+			}
+			for (auto&& s : servers) {
+				s->Flush();
+			}
+			mallocs += uv.sendPool.mallocCount - m;
+			news += numNews - n;
+			if (sent == numPkgs) {
+				sender.reset();
+			}
+		});
+	};
+
+	listener->onAccept = [&](xx::UvPeer_s p) {
+		servers.push_back(p);
+		if ((int)servers.size() == numPeers) {
+			Start();
+		}
+	};
+	for (int i = 0; i < numPeers; ++i) {
+		auto&& d = xx::Make<xx::UvDialer>(uv);
+		d->onAccept = [&](xx::UvPeer_s p) {
+			CHECK(p);
+			clients.push_back(p);
+			p->onReceivePush = [&](xx::Object_s&& o) {
+				if (++received == numPkgs * numPeers) {
+					uv.Stop();
+				}
+				return 0;
+			};
+		};
+		CHECK(!d->Dial("127.0.0.1", 23461, 2000));
+		dialers.push_back(d);
+	}
+	xx::UvTimer_s timeout;
+	xx::MakeTo(timeout, uv, 30000, 0, [&] {
+		uv.Stop();
+	});
+	uv.Run();
+	auto&& ms = double(NowNS() - t) / 1000000;
+	CHECK(received == numPkgs * numPeers);
+	auto&& total = double(numPkgs) * numPeers;
+	printf("%-15s burst = %4d    sends = %8.0f    pool mallocs = %6zu    operator new / send = %.3f    %.1f ms\n"
+		, shared ? "SendSharedPush" : "SendPush", burst, total, mallocs, double(news) / total, ms);
+	for (auto&& p : clients) {
+		p->Dispose(1);
+	}
+	for (auto&& p : servers) {
+		p->Dispose(1);
+	}
+	listener->Dispose(1);
+}
+
+int main(int argc, char** argv) {
+	signal(SIGPIPE, SIG_IGN);
+	auto&& numPkgs = ArgInt(argc, argv, 1, 100000);
+	auto&& numPeers = ArgInt(argc, argv, 2, 4);
+	for (auto&& burst : { 10, 1000 }) {
+		Run(numPkgs, numPeers, burst, false);
+		Run(numPkgs, numPeers, burst, true);
+	}
+	return 0;
+}
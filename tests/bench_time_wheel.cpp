@@ -0,0 +1,77 @@
+﻿// 空闲连接的计时开销: Uv::wheel( 每连接一个 UvWheelNode, 同 UvPeer::updater ) vs 每连接一个 10ms uv_timer( 旧 UvPeer 的做法 )
+// 用法: bench_time_wheel 连接数 [连接数...] 秒数. 输出 loop 的 cpu 占用
+#include "xx_uv.h"
+#include "bench.h"
+#include <vector>
+
+// 跑 seconds 秒 loop, 返回 cpu 占用百分比
+static double RunLoop(xx::Uv& uv, int const& seconds) {
+	xx::UvTimer_s stop;
+	xx::MakeTo(stop, uv, uint64_t(seconds) * 1000, 0, [&] { uv.Stop(); });
+	auto t = NowNS();
+	auto c = CpuNS();
+	uv.Run();
+	return double(CpuNS() - c) * 100 / double(NowNS() - t);
+}
+
+// 新: 空闲连接 60 秒超时, 挂在时间轮上. 另挂一批 50ms 超时的 校验触发
+static double BenchWheel(int const& n, int const& seconds) {
+	xx::Uv uv;
+	std::vector<xx::UvWheelNode> nodes(n);
+	auto now = xx::NowSteadyEpochMS();
+	int fired = 0;
+	for (auto&& node : nodes) {
+		node.onTimeout = [&] { ++fired; };
+		uv.wheel.Add(&node, now + 60000);
+	}
+	std::vector<xx::UvWheelNode> shorts(100);
+	int shortFired = 0;
+	for (auto&& node : shorts) {
+		node.onTimeout = [&] { ++shortFired; };
+		uv.wheel.Add(&node, now + 50);
+	}
+	auto r = RunLoop(uv, seconds);
+	CHECK(fired == 0);
+	CHECK(shortFired == (int)shorts.size());
+	CHECK(uv.wheel.count == nodes.size());
+	for (auto&& node : nodes) {
+		node.Unlink();
+	}
+	return r;
+}
+
+// 旧: 每连接一个 10ms 重复 timer, 每次触发检查超时
+static double BenchTimers(int const& n, int const& seconds) {
+	xx::Uv uv;
+	std::vector<xx::UvTimer_s> timers(n);
+	auto deadline = xx::NowSteadyEpochMS() + 60000;
+	int fired = 0;
+	for (auto&& t : timers) {
+		xx::MakeTo(t, uv, 10, 10, [&] {
+			if (xx::NowSteadyEpochMS() > deadline) {
+				++fired;
+			}
+		});
+	}
+	auto r = RunLoop(uv, seconds);
+	CHECK(fired == 0);
+	timers.clear();
+	return r;
+}
+
+int main(int argc, char** argv) {
+	std::vector<int> ns;
+	for (int i = 1; i + 1 < argc; ++i) {
+		ns.push_back(atoi(argv[i]));
+	}
+	if (ns.empty()) {
+		ns = { 1000, 10000, 50000 };
+	}
+	auto seconds = argc > 1 ? atoi(argv[argc - 1]) : 2;
+	for (auto&& n : ns) {
+		auto w = BenchWheel(n, seconds);
+		auto t = BenchTimers(n, seconds);
+		printf("idle peers = %6d    wheel cpu = %6.2f%%    per-peer uv_timer cpu = %6.2f%%\n", n, w, t);
+	}
+	return 0;
+}
@@ -0,0 +1,110 @@
+﻿// 多生产者 Dispatch 吞吐: xx::UvAsync( 无锁 MPSC + fixed_function, 每次唤醒执行完全部 ) vs 旧式 mutex + deque<std::function>( 同样每次唤醒取空 )
+// P 个线程各 Dispatch N 个函数, loop 线程执行( 计数 & 累加 ), 全部执行完即停. 统计 总耗时, 唤醒次数, 并校验累加和
+// 用法: bench_uv_async [每线程函数数 = 1000000] [最大生产者线程数 = 4]
+#include "xx_uv.h"
+#include "bench.h"
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Counter {
+	xx::Uv* uv = nullptr;
+	int64_t total = 0;
+	int64_t count = 0;
+	int64_t sum = 0;
+	void Add(int64_t const& v) {
+		sum += v;
+		if (++count == total) {
+			uv->Stop();
+		}
+	}
+};
+
+// 旧实现的队列部分( 直接用 uv_async_t )
+struct MutexAsync {
+	uv_async_t h;
+	std::mutex mtx;
+	std::deque<std::function<void()>> actions;
+	int64_t wakeups = 0;
+
+	MutexAsync(xx::Uv& uv) {
+		h.data = this;
+		CHECK(!uv_async_init(&uv.uvLoop, &h, [](uv_async_t* h) {
+			auto self = (MutexAsync*)h->data;
+			++self->wakeups;
+			std::deque<std::function<void()>> as;
+			{
+				std::lock_guard<std::mutex> g(self->mtx);
+				std::swap(as, self->actions);
+			}
+			for (auto&& a : as) {
+				a();
+			}
+		}));
+	}
+	int Dispatch(std::function<void()>&& a) {
+		{
+			std::lock_guard<std::mutex> g(mtx);
+			actions.push_back(std::move(a));
+		}
+		return uv_async_send(&h);
+	}
+};
+
+template<typename Dispatcher>
+static int64_t Produce(xx::Uv& uv, Counter& c, int const& numThreads, int const& n, Dispatcher&& dispatch) {
+	c.total = (int64_t)numThreads * n;
+	auto t = NowNS();
+	std::vector<std::thread> ts;
+	for (int i = 0; i < numThreads; ++i) {
+		ts.emplace_back([&, i] {
+			for (int j = 0; j < n; ++j) {
+				int64_t v = (int64_t)i * n + j;
+				CHECK(!dispatch([&c, v] { c.Add(v); }));
+			}
+		});
+	}
+	uv.Run();
+	auto d = NowNS() - t;
+	for (auto&& th : ts) {
+		th.join();
+	}
+	CHECK(c.count == c.total);
+	CHECK(c.sum == c.total * (c.total - 1) / 2);
+	return d;
+}
+
+int main(int argc, char** argv) {
+	auto&& n = ArgInt(argc, argv, 1, 1000000);
+	auto&& maxThreads = ArgInt(argc, argv, 2, 4);
+
+	for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+		double nsLockFree = 0, nsMutex = 0;
+		int64_t wakeups = 0;
+		{
+			xx::Uv uv;
+			Counter c;
+			c.uv = &uv;
+			auto&& async = xx::Make<xx::UvAsync>(uv);
+			auto d = Produce(uv, c, numThreads, n, [&](auto&& f) { return async->Dispatch(std::move(f)); });
+			nsLockFree = double(d) / c.total;
+			async->Dispose();
+		}
+		{
+			xx::Uv uv;
+			Counter c;
+			c.uv = &uv;
+			MutexAsync async(uv);
+			auto d = Produce(uv, c, numThreads, n, [&](auto&& f) { return async.Dispatch(std::move(f)); });
+			nsMutex = double(d) / c.total;
+			wakeups = async.wakeups;
+			uv_close((uv_handle_t*)&async.h, nullptr);
+			uv.Run(UV_RUN_NOWAIT);
+		}
+		printf("producers = %d  actions = %lld  UvAsync = %5.1f ns/action  mutex + deque = %5.1f ns/action ( wakeups = %lld )\n"
+			, numThreads, (long long)numThreads * n, nsLockFree, nsMutex, (long long)wakeups);
+	}
+	return 0;
+}
@@ -0,0 +1,144 @@
+﻿#pragma once
+// 以服务器模式( 不定义 CC_TARGET_PLATFORM )包含游戏逻辑, 不依赖 cocos
+// 用法: 建 xx::Uv 与 Service( 会监听 12345 ), 不 Run uv, 直接手动驱动 scene / catchFish 的 Update. calc 不会连上, hit 全走本地判定
+// calc 服务的协议包 由服务器工程的生成物提供, 不在本仓库. 此处按 Scene 用到的字段给出最小定义( typeId 取生成物之外的值 )
+#include "xx_uv.h"
+#include <algorithm>
+#include <vector>
+
+namespace PKG {
+	namespace CatchFish_Calc {
+		struct Hit {
+			int fishId = 0;
+			int64_t fishCoin = 0;
+			int playerId = 0;
+			int cannonId = 0;
+			int bulletId = 0;
+			int bulletCount = 0;
+			int64_t bulletCoin = 0;
+		};
+		struct HitCheck : xx::Object {
+			xx::List_s<Hit> hits;
+			uint16_t GetTypeId() const noexcept override { return 900; }
+		};
+		using HitCheck_s = std::shared_ptr<HitCheck>;
+	}
+	namespace Calc_CatchFish {
+		struct Fish {
+			int fishId = 0;
+			int64_t fishCoin = 0;
+			int64_t bulletCoin = 0;
+			int playerId = 0;
+			int cannonId = 0;
+			int bulletId = 0;
+		};
+		struct Bullet {
+			int playerId = 0;
+			int cannonId = 0;
+			int bulletId = 0;
+			int64_t bulletCoin = 0;
+			int bulletCount = 0;
+		};
+		struct HitCheckResult : xx::Object {
+			xx::List_s<Fish> fishs;
+			xx::List_s<Bullet> bullets;
+			uint16_t GetTypeId() const noexcept override { return 901; }
+		};
+		using HitCheckResult_s = std::shared_ptr<HitCheckResult>;
+	}
+}
+namespace xx {
+	template<> struct TypeId<PKG::CatchFish_Calc::HitCheck> { static const uint16_t value = 900; };
+	template<> struct TypeId<PKG::Calc_CatchFish::HitCheckResult> { static const uint16_t value = 901; };
+}
+
+#include "CatchFish.h"
+
+// 注册类型并加载 res/cfg.bin( 路径由 CMake 传入 ). 失败直接退出
+inline PKG::CatchFish::Configs::Config_s LoadTestConfig() {
+	PKG::AllTypesRegister();
+	PKG::CatchFish::Configs::Config_s cfg;
+	if (int r = CatchFish::LoadConfig(CFG_BIN_PATH, cfg)) {
+		printf("LoadConfig(%s) failed. r = %d\n", CFG_BIN_PATH, r);
+		exit(1);
+	}
+	return cfg;
+}
+
+// 把一个 Bet / Fire / Hit 按 Peer::HandlePack 的方式( 只存包体 )放入玩家收包队列, 以场景当前帧计限流. 返回 Recvs::Push 的结果
+inline int PushTestPkg(PKG::CatchFish::Player& p, xx::Object const& o) {
+	thread_local xx::BBuffer bb;
+	size_t limiterIndex;
+	switch (o.GetTypeId()) {
+	case xx::TypeId_v<PKG::Client_CatchFish::Bet>: limiterIndex = 0; break;
+	case xx::TypeId_v<PKG::Client_CatchFish::Fire>: limiterIndex = 1; break;
+	case xx::TypeId_v<PKG::Client_CatchFish::Hit>: limiterIndex = 2; break;
+	default: return -4;
+	}
+	bb.Clear();
+	o.ToBBuffer(bb);
+	return p.recvs.Push(limiterIndex, o.GetTypeId(), bb.buf, bb.len, p.scene->frameNumber);
+}
+
+// 以玩家首个炮台 按 angle 开一炮( 帧编号取场景当前帧, 子弹 id 取 player.autoIncId 自增 ). 返回 PushTestPkg 的结果
+inline int PushTestFire(PKG::CatchFish::Player& p, float const& angle) {
+	thread_local auto&& o = xx::Make<PKG::Client_CatchFish::Fire>();
+	o->frameNumber = p.scene->frameNumber;
+	o->cannonId = p.cannons->At(0)->id;
+	o->bulletId = ++p.autoIncId;
+	o->angle = angle;
+	return PushTestPkg(p, *o);
+}
+
+// 模拟客户端: 按客户端的方式为首个炮台开火, 并为 飞出屏幕 或 打中鱼 的子弹上报 Hit( 服务器只在收到 Hit 时回收子弹 )
+// 只往 player->recvs 放包, 由 Scene::Update 处理. 不持有 player( 被踢时 Scene::Update 断言 player 已释放 )
+struct TestClient {
+	PKG::CatchFish::Player* player;
+	std::vector<int> pendingHits;						// 已上报 Hit 但尚未被处理的 子弹 id
+
+	explicit TestClient(PKG::CatchFish::Player* const& player) : player(player) {}
+
+	// 炮台 CD, 子弹数上限, 金币 都允许时才开火( 同客户端 ). 开火 返回 true
+	bool Fire(float const& angle) {
+		auto&& c = *player->cannons->At(0);
+		if (player->scene->frameNumber < c.fireCD || (int)c.bullets->len >= c.cfg->numLimit || player->coin < c.coin) return false;
+		return !PushTestFire(*player, angle);
+	}
+
+	// 扫子弹 上报 Hit. 被限流 则留到下一帧再报
+	void Hits() {
+		thread_local auto&& o = xx::Make<PKG::Client_CatchFish::Hit>();
+		auto&& c = *player->cannons->At(0);
+		for (size_t i = pendingHits.size() - 1; i != (size_t)-1; --i) {
+			if (c.bulletById.Find(pendingHits[i]) == -1) {
+				pendingHits[i] = pendingHits.back();
+				pendingHits.pop_back();
+			}
+		}
+		auto&& fs = *player->scene->fishs;
+		for (auto&& b : *c.bullets) {
+			if (std::find(pendingHits.begin(), pendingHits.end(), b->id) != pendingHits.end()) continue;
+			o->cannonId = c.id;
+			o->bulletId = b->id;
+			bool found = true;
+			auto&& w = designSize_2.x + c.cfg->maxRadius;
+			auto&& h = designSize_2.y + c.cfg->maxRadius;
+			if (b->pos.x > w || b->pos.x < -w || b->pos.y > h || b->pos.y < -h) {
+				o->fishId = 0;								// 服务器不做反弹, 出屏即撤销
+			}
+			else {
+				found = false;
+				for (size_t j = fs.len - 1; j != (size_t)-1; --j) {
+					if (fs[j]->HitCheck(&*b)) {
+						o->fishId = fs[j]->id;
+						found = true;
+						break;
+					}
+				}
+			}
+			if (!found) continue;
+			if (PushTestPkg(*player, *o)) return;
+			pendingHits.push_back(b->id);
+		}
+	}
+};
@@ -0,0 +1,120 @@
+﻿// 无 cocos 的无头模拟: 加载 cfg.bin, 按脚本把 Bet / Fire / Hit 经 Player::recvs.Push 喂给场景, 逐帧输出 Scene::CalcHash, 最后输出 帧率( 只计 Update )
+// 同一脚本两次运行( 或 重构前后 )的 hash 序列必须完全一致. 用法: catchfish_sim 脚本文件 [cfg.bin 路径]
+// 脚本: 每行一条, # 开头为注释
+//   players 玩家数                   坐下的玩家数( 默认 1 )
+//   frames 帧数                      模拟帧数( 默认 600 )
+//   帧号 玩家下标 fire 角度          以首个炮台开火, 子弹 id 自增( 从 1 起 )
+//   帧号 玩家下标 hit 子弹id 鱼id    上报命中( 鱼id 0: 子弹出屏 )
+//   帧号 玩家下标 bet 炮注           修改首个炮台的炮注
+// 帧号 N 的命令在场景推进到第 N 帧后放入, 由下一次 Update 处理. 命令须按帧号升序
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+struct Command {
+	int frameNumber;
+	int playerIndex;
+	std::string name;
+	double a, b;
+};
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		printf("usage: %s script [cfg.bin]\n", argv[0]);
+		return 1;
+	}
+	std::ifstream f(argv[1]);
+	if (!f) {
+		printf("open %s failed.\n", argv[1]);
+		return 1;
+	}
+	int numPlayers = 1, numFrames = 600;
+	std::vector<Command> cmds;
+	std::string line;
+	for (int lineNumber = 1; std::getline(f, line); ++lineNumber) {
+		std::istringstream ss(line);
+		std::string s;
+		if (!(ss >> s) || s[0] == '#') continue;
+		if (s == "players") {
+			ss >> numPlayers;
+		}
+		else if (s == "frames") {
+			ss >> numFrames;
+		}
+		else {
+			Command c{};
+			c.frameNumber = atoi(s.c_str());
+			ss >> c.playerIndex >> c.name >> c.a;
+			if (c.name == "hit") {
+				ss >> c.b;
+			}
+			if (!ss || (c.name != "fire" && c.name != "hit" && c.name != "bet") || (cmds.size() && cmds.back().frameNumber > c.frameNumber)) {
+				printf("bad line %d: %s\n", lineNumber, line.c_str());
+				return 1;
+			}
+			cmds.push_back(c);
+		}
+	}
+
+	PKG::AllTypesRegister();
+	PKG::CatchFish::Configs::Config_s cfg;
+	auto&& cfgPath = argc > 2 ? argv[2] : CFG_BIN_PATH;
+	if (int r = CatchFish::LoadConfig(cfgPath, cfg)) {
+		printf("LoadConfig(%s) failed. r = %d\n", cfgPath, r);
+		return 1;
+	}
+	xx::Uv uv;
+	Service service(uv, cfg, true);
+	std::vector<int> playerIds;
+	for (int i = 0; i < numPlayers; ++i) {
+		auto&& p = service.SeatPlayer();
+		CHECK(p);
+		playerIds.push_back(p->id);
+	}
+	auto&& scene = *service.catchFish->scenes[0];
+
+	auto&& fire = xx::Make<PKG::Client_CatchFish::Fire>();
+	auto&& hit = xx::Make<PKG::Client_CatchFish::Hit>();
+	auto&& bet = xx::Make<PKG::Client_CatchFish::Bet>();
+	size_t ci = 0;
+	int64_t ns = 0;
+	for (int i = 0; i < numFrames; ++i) {
+		for (; ci < cmds.size() && cmds[ci].frameNumber <= scene.frameNumber; ++ci) {
+			auto&& c = cmds[ci];
+			// 被踢或超时离开的玩家 忽略其后续命令
+			auto&& p = c.playerIndex >= 0 && c.playerIndex < numPlayers ? service.catchFish->FindPlayer(playerIds[c.playerIndex]) : nullptr;
+			if (!p) continue;
+			auto&& cannonId = p->cannons->At(0)->id;
+			int r;
+			if (c.name == "fire") {
+				fire->frameNumber = scene.frameNumber;
+				fire->cannonId = cannonId;
+				fire->bulletId = ++p->autoIncId;
+				fire->angle = (float)c.a;
+				r = PushTestPkg(*p, *fire);
+			}
+			else if (c.name == "hit") {
+				hit->cannonId = cannonId;
+				hit->bulletId = (int)c.a;
+				hit->fishId = (int)c.b;
+				r = PushTestPkg(*p, *hit);
+			}
+			else {
+				bet->cannonId = cannonId;
+				bet->coin = (int64_t)c.a;
+				r = PushTestPkg(*p, *bet);
+			}
+			if (r) {
+				printf("frame %d player %d %s: push failed. r = %d\n", scene.frameNumber, c.playerIndex, c.name.c_str(), r);
+			}
+		}
+		auto t = NowNS();
+		CHECK(!scene.Update());
+		ns += NowNS() - t;
+		printf("%d %016llx\n", scene.frameNumber, (unsigned long long)scene.CalcHash());
+	}
+	printf("frames = %d  fps = %.0f\n", numFrames, ns ? numFrames * 1e9 / ns : 0.0);
+	return 0;
+}
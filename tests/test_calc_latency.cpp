@@ -0,0 +1,174 @@
+﻿// Calc 延迟下的 hit 流水线: 以假 Calc( 不走网络的 UvPeerBase )替换 service->calcPeer, 每批 hit 随机延迟若干帧才回复( 可乱序 / 超时 )
+// 同一条鱼会被多个在途批次反复打中. 每次回复前按 "只有第一个打死算数, 其余退子弹钱" 推算各玩家 coin, 回复后必须与 Scene::Handle 的结果一致( 无重复赔付 )
+// 在途批次达到 maxCalcRequests 时 Scene 会改走本地判定, 同样不应出错
+// 用法: test_calc_latency [帧数 = 20000] [最大延迟帧数 = 20]
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+using Hits = std::vector<PKG::CatchFish_Calc::Hit>;
+
+struct CalcRequest {
+	int deliverFrame;
+	int serial;
+	Hits hits;
+};
+
+// 只记下 SendRequest 发出的 HitCheck( serial 为负 ), 由 main 择时回复
+struct FakeCalc : xx::UvPeerBase {
+	std::vector<CalcRequest> requests;
+	xx::Random* rnd = nullptr;
+	int maxLatency = 0;
+	int* frameNumber = nullptr;
+	bool disposed = false;
+
+	using xx::UvPeerBase::UvPeerBase;
+	~FakeCalc() { this->Dispose(0); }
+	bool Disposed() const noexcept override { return disposed; }
+	void Dispose(int const& flag) noexcept override { disposed = true; }
+	std::string GetIP() noexcept override { return "fake calc"; }
+	int SendPackage(xx::Object_s const& data, int32_t const& serial) noexcept override {
+		auto&& hc = xx::As<PKG::CatchFish_Calc::HitCheck>(data);
+		CHECK(hc && serial < 0);
+		requests.push_back(CalcRequest{ *frameNumber + rnd->Next(1, maxLatency + 1), -serial, Hits(hc->hits->buf, hc->hits->buf + hc->hits->len) });
+		return 0;
+	}
+	int SendPackage(xx::BBuffer const& data, int32_t const& serial) noexcept override { return -1; }
+	int SendSharedPackage(xx::BBuffer_s const& data, int32_t const& serial) noexcept override { return -1; }
+	void Flush() noexcept override {}
+	int Update(int64_t const& nowMS) noexcept override { return 0; }
+	bool IsKcp() noexcept override { return false; }
+};
+
+int main(int argc, char** argv) {
+	auto&& numFrames = ArgInt(argc, argv, 1, 20000);
+	auto&& maxLatency = ArgInt(argc, argv, 2, 20);
+
+	auto&& cfg = LoadTestConfig();
+	xx::Uv uv;
+	Service service(uv, cfg, true);
+	auto&& catchFish = *service.catchFish;
+	std::vector<TestClient> clients;
+	for (int i = 0; i < 4; ++i) {
+		auto&& p = service.SeatPlayer();
+		CHECK(p);
+		p->coin = std::numeric_limits<int>::max() / 2;
+		clients.emplace_back(&*p);
+	}
+	auto&& scene = *catchFish.scenes[0];
+
+	xx::Random rnd(1);
+	auto&& calcPeer = xx::Make<xx::UvPeer>(uv);
+	auto&& fake = xx::Make<FakeCalc>(uv);
+	fake->peer = &*calcPeer;
+	fake->rnd = &rnd;
+	fake->maxLatency = maxLatency;
+	fake->frameNumber = &scene.frameNumber;
+	calcPeer->peerBase = fake;
+	service.calcPeer = calcPeer;
+
+	int numBatchs = 0, numTimeouts = 0, numKills = 0, numRepeatHits = 0;
+	size_t maxInFlight = 0;
+
+	// 回复一批. 先推算 coin 变化, 回复后核对
+	auto&& Deliver = [&](CalcRequest const& req) {
+		std::unordered_map<int, int64_t> coins;
+		for (auto&& c : clients) {
+			coins[c.player->id] = c.player->coin;
+		}
+		auto&& Expect = [&](int const& playerId, int64_t const& coin) {
+			if (catchFish.FindPlayer(playerId)) {
+				coins[playerId] += coin;
+			}
+		};
+
+		xx::Object_s msg;
+		std::unordered_map<int, bool> killed;
+		if (rnd.Next(100) < 3) {
+			// 超时: 全部退钱
+			++numTimeouts;
+			for (auto&& h : req.hits) {
+				Expect(h.playerId, h.bulletCoin * h.bulletCount);
+			}
+		}
+		else {
+			// 一半打死, 一成退钱, 其余消耗. 同一条鱼只有第一个打死的算数
+			auto&& r = xx::Make<PKG::Calc_CatchFish::HitCheckResult>();
+			xx::MakeTo(r->fishs);
+			xx::MakeTo(r->bullets);
+			for (auto&& h : req.hits) {
+				auto&& v = rnd.Next(10);
+				if (v < 5) {
+					r->fishs->Add(PKG::Calc_CatchFish::Fish{ h.fishId, h.fishCoin, h.bulletCoin, h.playerId, h.cannonId, h.bulletId });
+					if (scene.FindFish(h.fishId) && !killed[h.fishId]) {
+						killed[h.fishId] = true;
+						Expect(h.playerId, h.fishCoin * h.bulletCoin);
+						++numKills;
+					}
+					else {
+						Expect(h.playerId, h.bulletCoin);
+						++numRepeatHits;
+					}
+				}
+				else if (v == 5) {
+					r->bullets->Add(PKG::Calc_CatchFish::Bullet{ h.playerId, h.cannonId, h.bulletId, h.bulletCoin, h.bulletCount });
+					Expect(h.playerId, h.bulletCoin * h.bulletCount);
+				}
+			}
+			msg = std::move(r);
+		}
+
+		auto&& idx = calcPeer->callbacks.Find(req.serial);
+		CHECK(idx != -1);
+		auto cb = std::move(calcPeer->callbacks.ValueAt(idx).first);
+		calcPeer->callbacks.RemoveAt(idx);
+		CHECK(!cb(std::move(msg)));
+		++numBatchs;
+
+		for (auto&& c : clients) {
+			if (c.player->coin != coins[c.player->id]) {
+				printf("coin mismatch at frameNumber = %d. playerId = %d, coin = %lld, expected = %lld\n"
+					, scene.frameNumber, c.player->id, (long long)c.player->coin, (long long)coins[c.player->id]);
+				CHECK(false);
+			}
+		}
+		for (auto&& kv : killed) {
+			CHECK(!scene.FindFish(kv.first));
+		}
+	};
+
+	while (scene.frameNumber < numFrames) {
+		for (auto&& c : clients) {
+			c.Hits();
+			(void)c.Fire(float(rnd.Next(0, 628)) / 100);
+		}
+		CHECK(!scene.Update());
+		maxInFlight = std::max(maxInFlight, scene.calcRequests.len);
+
+		// 到期的乱序回复
+		auto&& rs = fake->requests;
+		for (size_t i = 0; i < rs.size();) {
+			if (rs[i].deliverFrame <= scene.frameNumber) {
+				auto req = std::move(rs[i]);
+				rs.erase(rs.begin() + i);
+				Deliver(req);
+			}
+			else ++i;
+		}
+	}
+	while (fake->requests.size()) {
+		auto req = std::move(fake->requests.back());
+		fake->requests.pop_back();
+		Deliver(req);
+	}
+	CHECK(!scene.calcRequests.len && !calcPeer->callbacks.Count());
+	CHECK(catchFish.players.len == clients.size());
+	CHECK(numBatchs > 0 && numRepeatHits > 0);
+
+	printf("frames = %d  batches = %d  timeouts = %d  kills = %d  repeat hits refunded = %d  max in flight = %zu\n"
+		, numFrames, numBatchs, numTimeouts, numKills, numRepeatHits, maxInFlight);
+	service.calcPeer.reset();
+	return 0;
+}
@@ -0,0 +1,65 @@
+﻿// Scene::FastForward( 追帧 ) 与 逐帧 Update 推进同样帧数后 CalcHash 必须一致
+// 两个 Service( 各自的 loop, 端口复用 ) 各建一个场景( 种子相同 ), 各坐 2 个模拟客户端. 按随机长度分段推进: 一边逐帧 Update, 一边一次 FastForward 到段尾
+// 客户端只在段尾 开火 / 上报 Hit( 两边输入相同 ), 段尾比对 hash
+// 用法: test_fast_forward [总帧数 = 20000] [最长段 = 120]
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <limits>
+#include <vector>
+
+struct Side {
+	xx::Uv uv;											// 同一 loop 中 kcp 端口不能重复监听, 故各用各的
+	Service service;
+	PKG::CatchFish::Scene* scene = nullptr;
+	std::vector<TestClient> clients;
+	xx::Random rnd;
+
+	Side(PKG::CatchFish::Configs::Config_s const& cfg) : service(uv, cfg, true), rnd(1) {
+		for (int i = 0; i < 2; ++i) {
+			auto&& p = service.SeatPlayer();
+			CHECK(p);
+			p->coin = std::numeric_limits<int>::max() / 2;
+			clients.emplace_back(&*p);
+		}
+		scene = &*service.catchFish->scenes[0];
+	}
+
+	void Input() {
+		for (auto&& c : clients) {
+			c.Hits();
+			(void)c.Fire(float(rnd.Next(0, 628)) / 100);
+		}
+	}
+};
+
+int main(int argc, char** argv) {
+	auto&& numFrames = ArgInt(argc, argv, 1, 20000);
+	auto&& maxStep = ArgInt(argc, argv, 2, 120);
+
+	auto&& cfg = LoadTestConfig();
+	Side a(cfg), b(cfg);
+	CHECK(a.scene->CalcHash() == b.scene->CalcHash());
+
+	xx::Random rnd(2);
+	int numSteps = 0;
+	while (a.scene->frameNumber < numFrames) {
+		a.Input();
+		b.Input();
+		auto&& target = a.scene->frameNumber + rnd.Next(1, maxStep + 1);
+		while (a.scene->frameNumber < target) {
+			CHECK(!a.scene->Update());
+		}
+		CHECK(!b.scene->FastForward(target));
+		CHECK(b.scene->frameNumber == target);
+		if (a.scene->CalcHash() != b.scene->CalcHash()) {
+			printf("hash mismatch at frameNumber = %d\n", target);
+			CHECK(false);
+		}
+		++numSteps;
+	}
+	CHECK(a.service.catchFish->players.len == 2 && b.service.catchFish->players.len == 2);
+	printf("frames = %d, steps = %d, fishs = %zu, bullets = %zu, coin = %lld, hash = %llx\n"
+		, a.scene->frameNumber, numSteps, a.scene->fishs->len, a.clients[0].player->cannons->At(0)->bullets->len
+		, (long long)a.clients[0].player->coin, (unsigned long long)a.scene->CalcHash());
+	return 0;
+}
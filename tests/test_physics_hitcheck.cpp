@@ -0,0 +1,152 @@
+﻿// Physics::HitCheck( 预处理凸包 ) 与 原 chipmunk 实现( 每个多边形 cpPolyShapeNew 进 cpSpace, 用 cpSpacePointQueryNearest 判定 ) 结果必须一致( float 精度下恰好擦边的 除外 )
+// 样本: cfg.bin 中所有鱼帧的 physics, 以及 随机生成的 凸 / 凹 / 反序 / 乱序 多边形. 点 & 半径 在多边形包围盒附近随机
+// 顺带输出两者的 ns/query
+// 用法: test_physics_hitcheck [每个 physics 的采样数 = 2000] [随机多边形组数 = 300]
+#include "catchfish_headless.h"
+#include "bench.h"
+#include "chipmunk.h"
+#include <cmath>
+#include <set>
+#include <vector>
+
+// 预编译的 libchipmunk.a 出自老 glibc, 引用了新 glibc 已移除的 __powf_finite( 只在 cpSpaceStep 中用到, 此处不会调用 )
+extern "C" float __powf_finite(float x, float y) {
+	return powf(x, y);
+}
+
+// 原 Physics::InitCascade 的写法
+static cpSpace* MakeSpace(PKG::CatchFish::Configs::Physics const& o) {
+	auto&& space = cpSpaceNew();
+	auto&& body = cpSpaceGetStaticBody(space);
+	for (auto&& polygon : *o.polygons) {
+		if (!polygon->len) continue;
+		cpSpaceAddShape(space, cpPolyShapeNew(body, (int)polygon->len, (cpVect*)polygon->buf, cpTransformIdentity, 0.0));
+	}
+	return space;
+}
+
+// 原 Physics::~Physics 的写法
+static void FreeSpace(cpSpace* const& space) {
+	cpSpaceEachShape(space, [](cpShape *shape, void *data) {
+		cpSpaceAddPostStepCallback((cpSpace*)data, [](cpSpace *space, void *key, void *data) {
+			cpSpaceRemoveShape(space, (cpShape *)key);
+			cpShapeFree((cpShape *)key);
+		}, shape, nullptr);
+	}, space);
+	cpSpaceFree(space);
+}
+
+static xx::Random rnd(1);
+static float RandF(float const& from, float const& to) {
+	return from + (to - from) * float(rnd.NextDouble());
+}
+
+static int64_t numQueries = 0, numHits = 0, numEdges = 0, oldNS = 0, newNS = 0;
+
+static void Compare(PKG::CatchFish::Configs::Physics const& o, int const& numSamples) {
+	static_assert(sizeof(cpVect) == sizeof(xx::Pos));
+	xx::Pos minXY{ 1e9f, 1e9f }, maxXY{ -1e9f, -1e9f };
+	for (auto&& polygon : *o.polygons) {
+		for (auto&& v : *polygon) {
+			if (v.x < minXY.x) minXY.x = v.x;
+			if (v.y < minXY.y) minXY.y = v.y;
+			if (v.x > maxXY.x) maxXY.x = v.x;
+			if (v.y > maxXY.y) maxXY.y = v.y;
+		}
+	}
+	struct Sample {
+		xx::Pos p;
+		float r;
+		bool b1, b2;
+	};
+	std::vector<Sample> ss(numSamples);
+	for (int i = 0; i < numSamples; ++i) {
+		ss[i].p = { RandF(minXY.x - 30, maxXY.x + 30), RandF(minXY.y - 30, maxXY.y + 30) };
+		ss[i].r = i % 10 ? RandF(0, 30) : 0.0f;			// 一成样本 半径为 0( 纯点选 )
+	}
+
+	auto&& space = MakeSpace(o);
+	auto t = NowNS();
+	for (auto&& s : ss) {
+		s.b1 = cpSpacePointQueryNearest(space, cpv(s.p.x, s.p.y), cpFloat(s.r), CP_SHAPE_FILTER_ALL, nullptr) != nullptr;
+	}
+	oldNS += NowNS() - t;
+	t = NowNS();
+	for (auto&& s : ss) {
+		s.b2 = o.HitCheck(s.p, s.r);
+	}
+	newNS += NowNS() - t;
+
+	for (auto&& s : ss) {
+		if (s.b1 != s.b2) {
+			// float 精度下 恰好擦边( 距离与半径相差 不到 1e-4 ): 半径稍放大 / 缩小 chipmunk 结果就会变, 允许不一致
+			auto&& hitLarger = cpSpacePointQueryNearest(space, cpv(s.p.x, s.p.y), cpFloat(s.r + 1e-4f), CP_SHAPE_FILTER_ALL, nullptr) != nullptr;
+			auto&& hitSmaller = cpSpacePointQueryNearest(space, cpv(s.p.x, s.p.y), cpFloat(s.r - 1e-4f), CP_SHAPE_FILTER_ALL, nullptr) != nullptr;
+			if (hitLarger != hitSmaller) {
+				++numEdges;
+				continue;
+			}
+			printf("mismatch: p = %.9g, %.9g  r = %.9g  chipmunk = %d  HitCheck = %d\n", s.p.x, s.p.y, s.r, s.b1, s.b2);
+			for (auto&& polygon : *o.polygons) {
+				printf("polygon:");
+				for (auto&& v : *polygon) {
+					printf(" %.9g, %.9g;", v.x, v.y);
+				}
+				printf("\n");
+			}
+			CHECK(false);
+		}
+		numHits += s.b1;
+	}
+	FreeSpace(space);
+	numQueries += numSamples;
+}
+
+int main(int argc, char** argv) {
+	auto&& numSamples = ArgInt(argc, argv, 1, 2000);
+	auto&& numRandoms = ArgInt(argc, argv, 2, 300);
+
+	// 配置中的 physics( 多鱼共图, 去重 )
+	auto&& cfg = LoadTestConfig();
+	std::set<PKG::CatchFish::Configs::Physics*> ps;
+	for (auto&& f : *cfg->fishs) {
+		for (auto&& sf : *f->moveFrames) {
+			if (sf->physics && sf->physics->polygons) {
+				ps.insert(&*sf->physics);
+			}
+		}
+	}
+	CHECK(ps.size());
+	for (auto&& p : ps) {
+		Compare(*p, numSamples);
+	}
+	printf("cfg physics: %zu, ", ps.size());
+
+	// 随机多边形: 绕一圈取点( 逆 / 顺时针, 半径随机 故可能凹 ), 或 随机散点( 乱序 / 自交 ). 双方都会取凸包
+	for (int i = 0; i < numRandoms; ++i) {
+		auto&& o = xx::Make<PKG::CatchFish::Configs::Physics>();
+		xx::MakeTo(o->polygons);
+		for (int n = rnd.Next(1, 4); n; --n) {
+			auto&& polygon = o->polygons->Emplace();
+			xx::MakeTo(polygon);
+			xx::Pos c{ RandF(-50, 50), RandF(-50, 50) };
+			auto&& numVerts = rnd.Next(3, 10);
+			auto&& kind = rnd.Next(3);
+			for (int j = 0; j < numVerts; ++j) {
+				if (kind == 2) {
+					polygon->Add(c + xx::Pos{ RandF(-40, 40), RandF(-40, 40) });
+				}
+				else {
+					auto&& a = float(M_PI * 2 * j / numVerts) * (kind ? -1 : 1);
+					polygon->Add(c + xx::Rotate(xx::Pos{ RandF(10, 40), 0 }, a));
+				}
+			}
+		}
+		CHECK(!o->InitCascade(nullptr));
+		Compare(*o, numSamples);
+	}
+	printf("random physics: %d, queries: %lld, hits: %lld, float edge cases: %lld\n", numRandoms, (long long)numQueries, (long long)numHits, (long long)numEdges);
+	printf("chipmunk : %6.1f ns/query\n", double(oldNS) / numQueries);
+	printf("HitCheck : %6.1f ns/query\n", double(newNS) / numQueries);
+	return 0;
+}
@@ -0,0 +1,155 @@
+﻿// 玩家收包队列( Player::Recvs )抗刷: 令牌桶限流 与 定长槽位环 在洪泛下的 接收数 / 限流数 / 溢出数, 以及 Push 不分配内存
+// 1. 单独的 Recvs: 积攒令牌后瞬时洪泛, 持续洪泛( 每帧取空 ), 不取的洪泛( 槽位满 ), 超长包体. 统计 ns/push
+// 2. 场景中: 一个刷包玩家 与 两个正常模拟客户端同场. 刷包者一帧内猛推 Fire, 只有令牌数以内的会被放入, 解析执行到违规的那个即被踢, 余下的随队列清空; 正常玩家不受影响
+// 用法: test_recv_spam [每帧推包数 = 1000] [帧数 = 600]
+#include "catchfish_headless.h"
+#include "bench.h"
+#include <limits>
+#include <new>
+#include <vector>
+
+static size_t numNews = 0;
+void* operator new(size_t n) {
+	++numNews;
+	if (auto p = malloc(n)) return p;
+	throw std::bad_alloc();
+}
+void* operator new(size_t n, std::nothrow_t const&) noexcept {
+	++numNews;
+	return malloc(n);
+}
+void operator delete(void* p) noexcept {
+	free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+	free(p);
+}
+
+using Recvs = PKG::CatchFish::Player::Recvs;
+
+int main(int argc, char** argv) {
+	auto&& numPerFrame = ArgInt(argc, argv, 1, 1000);
+	auto&& numFrames = ArgInt(argc, argv, 2, 600);
+
+	auto&& cfg = LoadTestConfig();
+	uint8_t body[Recvs::slotSize + 1] = {};
+	uint16_t typeIds[3] = { xx::TypeId_v<PKG::Client_CatchFish::Bet>, xx::TypeId_v<PKG::Client_CatchFish::Fire>, xx::TypeId_v<PKG::Client_CatchFish::Hit> };
+	int64_t pushNS = 0, numPushCalls = 0;
+	size_t news = 0;
+
+	// 瞬时洪泛: 空闲 idle 帧后一次推 numPerFrame 个, 放入数 = 攒下的令牌( 不超过 burst )
+	for (int idle : { 0, 1, 30, 60, 600 }) {
+		auto&& rs = std::make_unique<Recvs>();
+		for (size_t li = 0; li < 3; ++li) {
+			auto&& l = rs->limiters[li];
+			auto expected = std::min<int64_t>((int64_t)idle * l.perSecond / 60, l.burst);
+			rs->Clear();
+			auto n = numNews;
+			auto t = NowNS();
+			int accepted = 0;
+			for (int i = 0; i < numPerFrame; ++i) {
+				accepted += rs->Push(li, typeIds[li], body, 8, idle) ? 0 : 1;
+			}
+			pushNS += NowNS() - t;
+			numPushCalls += numPerFrame;
+			news += numNews - n;
+			CHECK(accepted == std::min<int64_t>(expected, numPerFrame));
+		}
+	}
+
+	// 持续洪泛: 每帧推满再取空, 放入数 不超过 burst + 帧数 * perSecond / 60
+	{
+		auto&& rs = std::make_unique<Recvs>();
+		int accepted[3] = {};
+		auto n = numNews;
+		auto t = NowNS();
+		for (int f = 1; f <= numFrames; ++f) {
+			for (int i = 0; i < numPerFrame; ++i) {
+				for (size_t li = 0; li < 3; ++li) {
+					accepted[li] += rs->Push(li, typeIds[li], body, 8, f) ? 0 : 1;
+				}
+			}
+			while (rs->count) {
+				rs->Pop();
+			}
+		}
+		pushNS += NowNS() - t;
+		numPushCalls += (int64_t)numFrames * numPerFrame * 3;
+		news += numNews - n;
+		for (size_t li = 0; li < 3; ++li) {
+			auto&& l = rs->limiters[li];
+			auto&& refill = (int64_t)numFrames * l.perSecond / 60;
+			CHECK(accepted[li] >= refill - 1 && accepted[li] <= l.burst + refill);
+		}
+		CHECK(!rs->numOverflows);
+		printf("sustained flood: %d frames x %d pkgs x 3 types  accepted Bet / Fire / Hit = %d / %d / %d  rate limited = %llu\n"
+			, numFrames, numPerFrame, accepted[0], accepted[1], accepted[2], (unsigned long long)rs->numRateLimited);
+	}
+
+	// 不取: 令牌够时 槽位满即溢出, 队列长度不超过 capacity
+	{
+		auto&& rs = std::make_unique<Recvs>();
+		auto n = numNews;
+		for (int f = 1; f <= numFrames; ++f) {
+			for (int i = 0; i < numPerFrame; ++i) {
+				(void)rs->Push(2, typeIds[2], body, 8, f);
+			}
+		}
+		news += numNews - n;
+		CHECK(rs->count == Recvs::capacity && rs->numPushs == Recvs::capacity);
+		CHECK(rs->numOverflows > 0);
+		CHECK(rs->Push(2, typeIds[2], body, Recvs::slotSize + 1, numFrames + 1000) == -3);
+		printf("no drain: queued = %zu  overflows = %llu  rate limited = %llu\n"
+			, rs->count, (unsigned long long)rs->numOverflows, (unsigned long long)rs->numRateLimited);
+	}
+	CHECK(!news);
+	printf("Push: %.1f ns/call, %zu allocations\n", double(pushNS) / numPushCalls, news);
+
+	// 场景中
+	xx::Uv uv;
+	Service service(uv, cfg, true);
+	auto&& catchFish = *service.catchFish;
+	std::vector<TestClient> clients;
+	for (int i = 0; i < 3; ++i) {
+		auto&& p = service.SeatPlayer();
+		CHECK(p);
+		p->coin = std::numeric_limits<int>::max() / 2;
+		clients.emplace_back(&*p);
+	}
+	auto&& scene = *clients[0].player->scene;
+	auto&& spammer = clients.back().player;
+	clients.pop_back();
+
+	xx::Random rnd(1);
+	int spamFrame = 60, spamAccepted = 0, spamBullets = 0;
+	for (int f = 0; f < numFrames; ++f) {
+		for (auto&& c : clients) {
+			c.Hits();
+			(void)c.Fire(float(rnd.Next(0, 628)) / 100);
+		}
+		auto&& spamming = scene.frameNumber == spamFrame;
+		if (spamming) {
+			auto n = numNews;
+			for (int i = 0; i < numPerFrame; ++i) {
+				spamAccepted += PushTestFire(*spammer, 0) ? 0 : 1;
+			}
+			CHECK(numNews == n);
+			CHECK((size_t)spamAccepted == spammer->recvs.count);
+			CHECK(spamAccepted <= spammer->recvs.limiters[1].burst);
+		}
+		CHECK(!scene.Update());
+		// 第二发即违反开火 CD 被踢( 断线, 清空收包队列 ). 玩家对象留到超时才移除
+		if (spamming) {
+			CHECK(!spammer->recvs.count);
+			spamBullets = (int)spammer->cannons->At(0)->bullets->len;
+			CHECK(spamBullets <= 1);
+		}
+	}
+	for (auto&& c : clients) {
+		CHECK(catchFish.FindPlayer(c.player->id));
+		CHECK(!c.player->recvs.numOverflows);
+	}
+	printf("scene: spammer pushed %d Fire in one frame, %d accepted, %d fired before kick. honest players rate limited = %llu / %llu\n"
+		, numPerFrame, spamAccepted, spamBullets, (unsigned long long)clients[0].player->recvs.numRateLimited, (unsigned long long)clients[1].player->recvs.numRateLimited);
+	return 0;
+}
@@ -43,6 +43,94 @@ namespace xx {
 		static const bool value = true;
 	};
 
+	// Ѱַ ָ -> ƫ ӳ( л WritePtr ר ). ̽, 2^n 
+	//   жϸǷЧ,  Clear Ϊ O(1) Ҳͷڴ, ڶ WriteRoot 
+	struct PtrDict {
+		struct Slot {
+			void const* key;
+			uint32_t value;
+			uint32_t gen;
+		};
+		Slot* slots = nullptr;
+		size_t cap = 0;										// 2^n
+		size_t count = 0;
+		uint32_t gen = 1;
+
+		PtrDict() = default;
+		PtrDict(PtrDict const&) = delete;
+		PtrDict& operator=(PtrDict const&) = delete;
+		~PtrDict() {
+			if (slots) ::free(slots);
+		}
+
+		inline bool Empty() const noexcept {
+			return !count;
+		}
+
+		inline void Clear() noexcept {
+			if (!count) return;
+			count = 0;
+			if (++gen == 0) {								// þ: 
+				memset(slots, 0, cap * sizeof(Slot));
+				gen = 1;
+			}
+		}
+
+		// ҵ򷵻 value ָ, 򷵻 nullptr
+		inline uint32_t* Find(void const* const& key) const noexcept {
+			if (!count) return nullptr;
+			for (auto i = Hash(key) & (cap - 1);; i = (i + 1) & (cap - 1)) {
+				auto&& s = slots[i];
+				if (s.gen != gen) return nullptr;
+				if (s.key == key) return &s.value;
+			}
+		}
+
+		// ǰȷ key 
+		inline void Add(void const* const& key, uint32_t const& value) noexcept {
+			if ((count + 1) * 2 > cap) {					//  0.5
+				Grow();
+			}
+			Insert(key, value);
+			++count;
+		}
+
+	protected:
+		inline static size_t Hash(void const* const& key) noexcept {
+			auto&& h = (uint64_t)(size_t)key * 0x9E3779B97F4A7C15ull;
+			return size_t(h >> 32);
+		}
+
+		inline void Insert(void const* const& key, uint32_t const& value) noexcept {
+			for (auto i = Hash(key) & (cap - 1);; i = (i + 1) & (cap - 1)) {
+				auto&& s = slots[i];
+				if (s.gen != gen) {
+					s.key = key;
+					s.value = value;
+					s.gen = gen;
+					return;
+				}
+				assert(s.key != key);
+			}
+		}
+
+		inline void Grow() noexcept {
+			auto oldSlots = slots;
+			auto oldCap = cap;
+			auto oldGen = gen;
+			cap = cap ? cap * 2 : 64;
+			slots = (Slot*)::calloc(cap, sizeof(Slot));
+			assert(slots);
+			gen = 1;
+			for (size_t i = 0; i < oldCap; ++i) {
+				if (oldSlots[i].gen == oldGen) {
+					Insert(oldSlots[i].key, oldSlots[i].value);
+				}
+			}
+			if (oldSlots) ::free(oldSlots);
+		}
+	};
+
 	struct BBuffer;
 	using BBuffer_s = std::shared_ptr<BBuffer>;
 	using BBuffer_w = std::weak_ptr<BBuffer>;
@@ -52,10 +140,15 @@ namespace xx {
 		size_t offsetRoot = 0;												// offsetֵд
 		size_t readLengthLimit = 0;											// ڴݸгȺϷУ
 
-		// todo: ЩΪָ, XxxxxRoot мⲢ
-		std::unordered_map<void*, size_t> ptrs;
-		std::unordered_map<size_t, std::shared_ptr<Object>> objIdxs;
-		std::unordered_map<size_t, std::shared_ptr<std::string>> strIdxs;
+		// WritePtr : ָ ->  offsetRoot ƫ
+		PtrDict ptrs;
+
+		// ReadPtr :   offsetRoot ƫ Ϊ±ܼ. 0: ; ż: (readObjs ± + 1) << 1; : (readStrs ± + 1) << 1 | 1
+		// ReadRoot ʱֻù, ڴ汣
+		List<uint32_t> readIdxs;
+		static constexpr size_t readIdxsKeepLen = 64 * 1024;	// ReadRoot ʱ readIdxs ˳(  )ͷ, ⳤռ 4 ڴ
+		List<std::shared_ptr<Object>> readObjs;
+		List<std::shared_ptr<std::string>> readStrs;
 
 		BBuffer() : Buffer() {}
 		BBuffer(BBuffer&& o) noexcept
@@ -66,7 +159,7 @@ namespace xx {
 		inline BBuffer& operator=(BBuffer&& o) noexcept {
 			this->Buffer::operator=(std::move(o));
 			std::swap(offset, o.offset);
-			// ptrs, objIdxs, strIdxs Ϊʱ, Ҫ
+			// ptrs, readIdxs, readObjs, readStrs Ϊʱ, Ҫ
 			return *this;
 		}
 		BBuffer(BBuffer const&) = delete;
@@ -122,19 +215,28 @@ namespace xx {
 		template<typename T>
 		void WriteRoot(std::shared_ptr<T> const& v) noexcept {
 			offsetRoot = len;
-			assert(ptrs.empty());
+			assert(ptrs.Empty());
 			Write(v);
-			ptrs.clear();
+			ptrs.Clear();
 		}
 
 		template<typename T>
 		int ReadRoot(std::shared_ptr<T>& v) noexcept {
 			offsetRoot = offset;
-			assert(objIdxs.empty());
-			assert(strIdxs.empty());
+			assert(readObjs.len == 0);
+			assert(readStrs.len == 0);
+			if (readIdxs.len < len - offset) {
+				readIdxs.Resize(len - offset);				//  0
+			}
 			int r = Read(v);
-			objIdxs.clear();
-			strIdxs.clear();
+			if (readIdxs.len > readIdxsKeepLen) {
+				readIdxs.Clear(true);
+			}
+			else if (readObjs.len || readStrs.len) {
+				memset(readIdxs.buf, 0, (offset - offsetRoot) * sizeof(uint32_t));
+			}
+			readObjs.Clear();
+			readStrs.Clear();
 			return r;
 		}
 
@@ -154,17 +256,18 @@ namespace xx {
 
 			Write(typeId);
 
-			auto iter = ptrs.find((void*)&*v);
+			auto p = ptrs.Find(&*v);
+			auto isFirst = !p;
 			size_t offs;
-			if (iter == ptrs.end()) {
+			if (isFirst) {
 				offs = len - offsetRoot;
-				ptrs[(void*)&*v] = offs;
+				ptrs.Add(&*v, (uint32_t)offs);
 			}
 			else {
-				offs = iter->second;
+				offs = *p;
 			}
 			Write(offs);
-			if (iter == ptrs.end()) {
+			if (isFirst) {
 				if constexpr (std::is_same_v<std::string, T>) {
 					Write(*v);
 				}
@@ -174,6 +277,14 @@ namespace xx {
 			}
 		}
 
+		// ֶƴ WriteRoot : дһ ״γ  ٱ   / ַ( typeId 1 ) ָͷ, Ǽ ptrs. ÷д
+		//  offsetRoot. ƴڼ ptrs , οǰеĶ
+		inline void WritePtrHeader(uint16_t const& typeId) noexcept {
+			assert(typeId);
+			Write(typeId);
+			Write(size_t(len - offsetRoot));
+		}
+
 		template<typename T>
 		int ReadPtr(std::shared_ptr<T>& v) noexcept {
 			static_assert(std::is_base_of_v<Object, T> || std::is_same_v<std::string, T>, "not support type??");
@@ -193,9 +304,13 @@ namespace xx {
 			size_t ptrOffset;
 			if (auto r = Read(ptrOffset)) return r;
 			if (ptrOffset == offs) {
+				if (readIdxs.len <= offs) {
+					readIdxs.Resize(len - offsetRoot);	// δ ReadRoot ֱ Read 
+				}
 				if constexpr (std::is_same_v<std::string, T>) {
 					v = xx::TryMake<std::string>();
-					strIdxs[ptrOffset] = v;
+					readStrs.Add(v);
+					readIdxs[ptrOffset] = uint32_t(readStrs.len << 1 | 1);
 					if (auto r = Read(*v)) return r;
 				}
 				else {
@@ -209,21 +324,25 @@ namespace xx {
 					}
 					v = std::dynamic_pointer_cast<T>(o);
 					if (!v) return -4;
-					objIdxs[ptrOffset] = o;
+					readObjs.Add(o);
+					readIdxs[ptrOffset] = uint32_t(readObjs.len << 1);
 					if (auto r = o->FromBBuffer(*this)) return r;
 				}
 			}
 			else {
 				if constexpr (std::is_same_v<std::string, T>) {
-					auto iter = strIdxs.find(ptrOffset);
-					if (iter == strIdxs.end()) return -5;
-					v = iter->second;
+					if (ptrOffset >= readIdxs.len) return -5;
+					auto idx = readIdxs[ptrOffset];
+					if (!(idx & 1) || (idx >> 1) > readStrs.len) return -5;
+					v = readStrs[(idx >> 1) - 1];
 				}
 				else {
-					auto iter = objIdxs.find(ptrOffset);
-					if (iter == objIdxs.end()) return -6;
-					if (iter->second->GetTypeId() != typeId) return -7;
-					v = std::dynamic_pointer_cast<T>(iter->second);
+					if (ptrOffset >= readIdxs.len) return -6;
+					auto idx = readIdxs[ptrOffset];
+					if (!idx || (idx & 1) || (idx >> 1) > readObjs.len) return -6;
+					auto&& o = readObjs[(idx >> 1) - 1];
+					if (o->GetTypeId() != typeId) return -7;
+					v = std::dynamic_pointer_cast<T>(o);
 					if (!v) return -8;
 				}
 			}
@@ -8,6 +8,7 @@
 #include <type_traits>
 #include <cstdlib>
 #include <cstring>
+#include <cstddef>
 #include <functional>
 #include <algorithm>
 #include <limits>
@@ -480,16 +481,108 @@ namespace xx {
 
 
 
+	// 池化分配. 类型内声明 static constexpr bool pooled = true; 即开启( 派生类随之开启 ), 之后 Make, MakeTo, TryMake( 含反序列化创建 ) 都走池
+	// 对象与 shared_ptr 控制块合并为一块内存( allocate_shared ), 释放后挂在 分类型空闲链表 上供下次复用
+	// 构造 & 析构照常执行( 构造函数即 reset ), 不会残留上次的状态. 空闲链表每线程一份( 多 loop 线程各跑各的场景时互不干扰 )
+
+	template<typename T, typename ENABLED = void>
+	struct IsPooled : std::false_type {};
+
+	template<typename T>
+	struct IsPooled<T, std::enable_if_t<T::pooled>> : std::true_type {};
+
+	template<typename T>
+	constexpr bool IsPooled_v = IsPooled<T>::value;
+
+	// 定长内存块空闲链表( 块的前 sizeof(void*) 字节存下一块地址 ). 最多缓存 cap 块, 多出的直接释放
+	// 链表为 thread_local, 只被所在线程访问, 无需加锁. 块在哪个线程释放就挂到哪个线程的链表( 不会破坏别的线程的链表 )
+	// 各 loop 线程的对象应在本线程 创建 & 销毁, 以便块在本线程内循环复用. 缓存的块于线程退出时释放
+	template<typename T>
+	struct PoolFreeList {
+		static_assert(sizeof(T) >= sizeof(void*));
+		static constexpr size_t cap = 4096;
+
+		struct Data {
+			void* head = nullptr;
+			size_t count = 0;
+			~Data() noexcept {
+				while (auto p = head) {
+					head = *(void**)p;
+					::operator delete(p);
+				}
+			}
+		};
+		inline static thread_local Data data;
+
+		inline static void* Alloc() {
+			auto&& d = data;
+			if (auto p = d.head) {
+				d.head = *(void**)p;
+				--d.count;
+				return p;
+			}
+			return ::operator new(sizeof(T));
+		}
+
+		inline static void Free(void* const& p) noexcept {
+			auto&& d = data;
+			if (d.count < cap) {
+				*(void**)p = d.head;
+				d.head = p;
+				++d.count;
+			}
+			else {
+				::operator delete(p);
+			}
+		}
+	};
+
+	// 配合 allocate_shared 使用的分配器. rebind 后的类型( 控制块 + 对象 ) 各自拥有一条空闲链表
+	template<typename T>
+	struct PoolAllocator {
+		using value_type = T;
+		PoolAllocator() noexcept = default;
+		template<typename U>
+		PoolAllocator(PoolAllocator<U> const&) noexcept {}
+
+		inline T* allocate(size_t const& n) {
+			static_assert(alignof(T) <= alignof(std::max_align_t));
+			if (n == 1) return (T*)PoolFreeList<T>::Alloc();
+			return (T*)::operator new(n * sizeof(T));
+		}
+
+		inline void deallocate(T* const& p, size_t const& n) noexcept {
+			if (n == 1) {
+				PoolFreeList<T>::Free(p);
+			}
+			else {
+				::operator delete(p);
+			}
+		}
+	};
+
+	template<typename T, typename U>
+	inline bool operator==(PoolAllocator<T> const&, PoolAllocator<U> const&) noexcept { return true; }
+
+	template<typename T, typename U>
+	inline bool operator!=(PoolAllocator<T> const&, PoolAllocator<U> const&) noexcept { return false; }
+
+
 	// make_shared, weak helpers
 
 	template<typename T, typename ...Args>
 	std::shared_ptr<T> Make(Args&&...args) {
-		return std::make_shared<T>(std::forward<Args>(args)...);
+		if constexpr (IsPooled_v<T>) {
+			return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+		}
+		else {
+			return std::make_shared<T>(std::forward<Args>(args)...);
+		}
 	}
 
 	template<typename T, typename ...Args>
 	std::shared_ptr<T>& MakeTo(std::shared_ptr<T>& v, Args&&...args) {
-		v = std::make_shared<T>(std::forward<Args>(args)...);
+		v = Make<T>(std::forward<Args>(args)...);
 		return v;
 	}
 
@@ -506,7 +599,7 @@ namespace xx {
 	template<typename T, typename ...Args>
 	std::shared_ptr<T> TryMake(Args&&...args) noexcept {
 		try {
-			return std::make_shared<T>(std::forward<Args>(args)...);
+			return Make<T>(std::forward<Args>(args)...);
 		}
 		catch (...) {
 			return std::shared_ptr<T>();
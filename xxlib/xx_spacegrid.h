@@ -0,0 +1,114 @@
+﻿#pragma once
+#include "xx_bbuffer.h"
+#include "xx_pos.h"
+
+namespace xx
+{
+	// 均匀网格( 碰撞检测 宽相粗筛 ). 以 0,0 为中心, 覆盖 size 大小的区域, 越界坐标 夹到 边缘格子
+	// 用法: 每帧 Clear -> 挨个 Add( 下标, 坐标, 半径 ) -> Build -> 用 At 取某点所在格子的 下标 数组
+	// Build 为计数排序, 结果按格子连续存放. 同一格子内的下标保持 Add 的先后顺序( 便于倒序扫描时与原遍历顺序一致 )
+	struct SpaceGrid {
+		float cellSize = 0;
+		float cellSize_1 = 0;												// 1 / cellSize
+		Pos halfSize;
+		int numCols = 0;
+		int numRows = 0;
+
+	protected:
+		struct Item {
+			int idx;
+			int colFrom, colTo, rowFrom, rowTo;
+		};
+		List<Item> items;													// Add 进来的东西
+		List<int> cellOffsets;												// 每个格子在 idxs 中的起始位置( 长度 格子数 + 1 )
+		List<int> idxs;														// 按格子连续存放的下标
+
+	public:
+		SpaceGrid() = default;
+		SpaceGrid(SpaceGrid const&) = delete;
+		SpaceGrid& operator=(SpaceGrid const&) = delete;
+
+		inline void Init(Pos const& size, float const& cellSize) noexcept {
+			assert(cellSize > 0);
+			this->cellSize = cellSize;
+			this->cellSize_1 = 1.0f / cellSize;
+			this->halfSize = size / 2;
+			numCols = (int)ceilf(size.x * cellSize_1);
+			numRows = (int)ceilf(size.y * cellSize_1);
+			if (numCols < 1) numCols = 1;
+			if (numRows < 1) numRows = 1;
+			cellOffsets.Resize((size_t)numCols * numRows + 1);
+			Clear();
+		}
+
+		inline void Clear() noexcept {
+			items.Clear();
+			idxs.Clear();
+			memset(cellOffsets.buf, 0, cellOffsets.len * sizeof(int));
+		}
+
+		// 放入一个圆形的东西( 覆盖其外接矩形所涉及的格子 ). 半径 <= 0 视作覆盖全部格子
+		inline void Add(int const& idx, Pos const& pos, float const& radius) noexcept {
+			assert(numCols);
+			auto&& o = items.Emplace();
+			o.idx = idx;
+			if (radius > 0) {
+				o.colFrom = ColIndex(pos.x - radius);
+				o.colTo = ColIndex(pos.x + radius);
+				o.rowFrom = RowIndex(pos.y - radius);
+				o.rowTo = RowIndex(pos.y + radius);
+			}
+			else {
+				o.colFrom = 0;
+				o.colTo = numCols - 1;
+				o.rowFrom = 0;
+				o.rowTo = numRows - 1;
+			}
+		}
+
+		// 生成格子数据. 之后才能 At
+		inline void Build() noexcept {
+			auto&& cs = cellOffsets.buf;
+			size_t total = 0;
+			for (auto&& o : items) {
+				for (int r = o.rowFrom; r <= o.rowTo; ++r) {
+					for (int c = o.colFrom; c <= o.colTo; ++c) {
+						++cs[r * numCols + c + 1];
+					}
+				}
+				total += size_t(o.rowTo - o.rowFrom + 1) * (o.colTo - o.colFrom + 1);
+			}
+			for (size_t i = 1; i < cellOffsets.len; ++i) {
+				cs[i] += cs[i - 1];
+			}
+			idxs.Resize(total);
+			// 借用 cs[i] 当 格子 i 的写入游标, 填完后 cs[i] 变为 格子 i + 1 的起始位置, 再整体后移一格还原
+			for (auto&& o : items) {
+				for (int r = o.rowFrom; r <= o.rowTo; ++r) {
+					for (int c = o.colFrom; c <= o.colTo; ++c) {
+						idxs[cs[r * numCols + c]++] = o.idx;
+					}
+				}
+			}
+			memmove(cs + 1, cs, (cellOffsets.len - 1) * sizeof(int));
+			cs[0] = 0;
+		}
+
+		// 返回 pos 所在格子的 下标 数组, 并填充长度
+		inline int const* At(Pos const& pos, int& len) const noexcept {
+			auto&& i = RowIndex(pos.y) * numCols + ColIndex(pos.x);
+			len = cellOffsets[i + 1] - cellOffsets[i];
+			return idxs.buf + cellOffsets[i];
+		}
+
+	protected:
+		inline int ColIndex(float const& x) const noexcept {
+			auto&& c = (int)floorf((x + halfSize.x) * cellSize_1);
+			return c < 0 ? 0 : (c >= numCols ? numCols - 1 : c);
+		}
+		inline int RowIndex(float const& y) const noexcept {
+			auto&& r = (int)floorf((y + halfSize.y) * cellSize_1);
+			return r < 0 ? 0 : (r >= numRows ? numRows - 1 : r);
+		}
+	};
+}
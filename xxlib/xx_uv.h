@@ -3,9 +3,305 @@
 #include "xx_bbuffer.h"
 #include "xx_dict.h"
 #include "ikcp.h"
+#include <atomic>
+#include <thread>
+#include <functional>
+
+// Linux( 非 Android )下 kcp 的 udp 收发走 recvmmsg / sendmmsg 批量系统调用. 可预定义 XX_UV_MMSG 为 0 关闭
+#ifndef XX_UV_MMSG
+#if defined(__linux__) && !defined(__ANDROID__)
+#define XX_UV_MMSG 1
+#else
+#define XX_UV_MMSG 0
+#endif
+#endif
+#if XX_UV_MMSG
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
 
 namespace xx {
+	struct UvTimeWheel;
+
+	// double linked list node( wheel slot head )
+	struct UvWheelLink {
+		UvWheelLink* prev = nullptr;
+		UvWheelLink* next = nullptr;
+	};
+
+	// intrusive timer of Uv's time wheel. hold as member, fill onTimeout, call uv.wheel.Add( &node, deadlineMS )
+	struct UvWheelNode : UvWheelLink {
+		UvTimeWheel* wheel = nullptr;				// not null: linked
+		uint64_t expire = 0;						// wheel tick
+		std::function<void()> onTimeout;
+
+		UvWheelNode() = default;
+		UvWheelNode(UvWheelNode const&) = delete;
+		UvWheelNode& operator=(UvWheelNode const&) = delete;
+		~UvWheelNode() { Unlink(); }
+
+		inline bool Linked() const noexcept {
+			return wheel != nullptr;
+		}
+		inline void Unlink() noexcept;
+	};
+
+	// hierarchical timing wheel( cascade like old linux kernel timer ). 1 tick = tickMS
+	// level 0: 256 slots( 2.56s ), level 1 ~ 3: 64 slots per level( 7.7 days ). longer deadline will be clamp & recascade
+	// node only touched when add / cascade / fire. when empty, stop the uv timer.
+	struct UvTimeWheel {
+		static const int64_t tickMS = 10;
+		static const int bits0 = 8;
+		static const int bitsN = 6;
+		static const uint64_t size0 = 1u << bits0;
+		static const uint64_t sizeN = 1u << bitsN;
+		static const uint64_t maxTicks = 1u << (bits0 + bitsN * 3);
+
+		UvWheelLink slots0[size0];
+		UvWheelLink slotsN[3][sizeN];
+		uv_timer_t uvTimer;
+		int64_t baseMS = 0;
+		uint64_t currTick = 0;
+		size_t count = 0;							// linked nodes count
+
+		UvTimeWheel() {
+			for (auto&& h : slots0) {
+				h.prev = h.next = &h;
+			}
+			for (auto&& hs : slotsN) {
+				for (auto&& h : hs) {
+					h.prev = h.next = &h;
+				}
+			}
+		}
+		UvTimeWheel(UvTimeWheel const&) = delete;
+		UvTimeWheel& operator=(UvTimeWheel const&) = delete;
+		~UvTimeWheel() {
+			Clear();
+		}
+
+		inline int Init(uv_loop_t* const& loop) noexcept {
+			baseMS = NowSteadyEpochMS();
+			uvTimer.data = this;
+			return uv_timer_init(loop, &uvTimer);
+		}
+
+		// call before loop close
+		inline void Close() noexcept {
+			Clear();
+			uv_close((uv_handle_t*)& uvTimer, nullptr);
+		}
+
+		// link( or relink ) node. fire at next tick if deadline is passed
+		inline void Add(UvWheelNode* const& n, int64_t const& deadlineMS) noexcept {
+			assert(n->onTimeout);
+			n->Unlink();
+			if (!count) {
+				currTick = NowTick();
+				uv_timer_start(&uvTimer, [](uv_timer_t* t) {
+					((UvTimeWheel*)t->data)->Update(NowSteadyEpochMS());
+					}, tickMS, tickMS);
+			}
+			auto&& ms = deadlineMS - baseMS;
+			n->expire = ms > 0 ? uint64_t((ms + tickMS - 1) / tickMS) : 0;
+			Link(n);
+		}
+
+		// process all passed ticks
+		inline void Update(int64_t const& nowMS) noexcept {
+			auto&& ms = nowMS - baseMS;
+			auto&& target = ms > 0 ? uint64_t(ms / tickMS) : 0;
+			while (count && currTick <= target) {
+				RunTick();
+			}
+			if (!count) {
+				uv_timer_stop(&uvTimer);
+			}
+		}
+
+	protected:
+		friend UvWheelNode;
+
+		inline uint64_t NowTick() const noexcept {
+			return uint64_t(NowSteadyEpochMS() - baseMS) / tickMS;
+		}
+
+		inline static void Insert(UvWheelLink& head, UvWheelLink* const& n) noexcept {
+			n->next = &head;
+			n->prev = head.prev;
+			head.prev->next = n;
+			head.prev = n;
+		}
+
+		inline void Link(UvWheelNode* const& n) noexcept {
+			if (n->expire < currTick) {
+				n->expire = currTick;
+			}
+			auto&& idx = n->expire - currTick;
+			if (idx >= maxTicks) {
+				idx = maxTicks - 1;
+				n->expire = currTick + idx;
+			}
+			UvWheelLink* head;
+			if (idx < size0) {
+				head = &slots0[n->expire & (size0 - 1)];
+			}
+			else if (idx < (1u << (bits0 + bitsN))) {
+				head = &slotsN[0][(n->expire >> bits0) & (sizeN - 1)];
+			}
+			else if (idx < (1u << (bits0 + bitsN * 2))) {
+				head = &slotsN[1][(n->expire >> (bits0 + bitsN)) & (sizeN - 1)];
+			}
+			else {
+				head = &slotsN[2][(n->expire >> (bits0 + bitsN * 2)) & (sizeN - 1)];
+			}
+			Insert(*head, n);
+			n->wheel = this;
+			++count;
+		}
+
+		// move all nodes from head to tmp( head will be empty )
+		inline static void Splice(UvWheelLink& head, UvWheelLink& tmp) noexcept {
+			if (head.next == &head) {
+				tmp.prev = tmp.next = &tmp;
+				return;
+			}
+			tmp.next = head.next;
+			tmp.prev = head.prev;
+			tmp.next->prev = &tmp;
+			tmp.prev->next = &tmp;
+			head.prev = head.next = &head;
+		}
+
+		// relink level n's current slot nodes to lower level. return slot index
+		inline uint64_t Cascade(int const& n) noexcept {
+			auto&& idx = (currTick >> (bits0 + bitsN * n)) & (sizeN - 1);
+			UvWheelLink tmp;
+			Splice(slotsN[n][idx], tmp);
+			while (tmp.next != &tmp) {
+				auto&& node = (UvWheelNode*)tmp.next;
+				node->Unlink();
+				Link(node);
+			}
+			return idx;
+		}
+
+		inline void RunTick() noexcept {
+			auto&& idx = currTick & (size0 - 1);
+			if (!idx && !Cascade(0) && !Cascade(1)) {
+				Cascade(2);
+			}
+			++currTick;
+			UvWheelLink tmp;
+			Splice(slots0[idx], tmp);
+			while (tmp.next != &tmp) {						// callback may unlink / relink any node
+				auto&& node = (UvWheelNode*)tmp.next;
+				node->Unlink();
+				node->onTimeout();
+			}
+		}
+
+		inline void Clear() noexcept {
+			auto&& f = [](UvWheelLink& h) {
+				while (h.next != &h) {
+					((UvWheelNode*)h.next)->Unlink();
+				}
+			};
+			for (auto&& h : slots0) f(h);
+			for (auto&& hs : slotsN) for (auto&& h : hs) f(h);
+		}
+	};
+
+	inline void UvWheelNode::Unlink() noexcept {
+		if (!wheel) return;
+		prev->next = next;
+		next->prev = prev;
+		prev = next = nullptr;
+		--wheel->count;
+		wheel = nullptr;
+	}
+
+	// size class( 2^n ) cache for send request + data memory. recycle when write finished. not thread safe
+	struct UvSendPool {
+		static const size_t minBits = 8;			// 256
+		static const size_t maxBits = 16;			// 64k. larger: direct malloc / free
+		static const size_t maxCount = 256;			// max cached blocks per size class
+		struct Block {
+			Block* next;
+		};
+		Block* heads[maxBits - minBits + 1] = {};
+		size_t counts[maxBits - minBits + 1] = {};
+		size_t mallocCount = 0;						// for stat
+
+		UvSendPool() = default;
+		UvSendPool(UvSendPool const&) = delete;
+		UvSendPool& operator=(UvSendPool const&) = delete;
+		~UvSendPool() {
+			for (auto&& h : heads) {
+				while (h) {
+					auto b = h;
+					h = h->next;
+					::free(b);
+				}
+			}
+		}
+
+		// cap: in: min size  out: real size( 2^n )
+		inline void* Alloc(size_t& cap) noexcept {
+			if (cap > (size_t(1) << maxBits)) {
+				++mallocCount;
+				return ::malloc(cap);
+			}
+			auto&& bits = cap <= (size_t(1) << minBits) ? minBits : Calc2n(cap - 1) + 1;
+			cap = size_t(1) << bits;
+			auto&& i = bits - minBits;
+			if (auto b = heads[i]) {
+				heads[i] = b->next;
+				--counts[i];
+				return b;
+			}
+			++mallocCount;
+			return ::malloc(cap);
+		}
+
+		// cap: memory's real size. malloc memory with non 2^n size is ok( direct free )
+		inline void Free(void* const& p, size_t const& cap) noexcept {
+			if (!p) return;
+			if (cap >= (size_t(1) << minBits) && cap <= (size_t(1) << maxBits) && !(cap & (cap - 1))) {
+				auto&& i = Calc2n(cap) - minBits;
+				if (counts[i] < maxCount) {
+					auto&& b = (Block*)p;
+					b->next = heads[i];
+					heads[i] = b;
+					++counts[i];
+					return;
+				}
+			}
+			::free(p);
+		}
+	};
+
+	// tcp coalesced write request: all packages of a peer in one loop iteration are written by one uv_write( multi uv_buf_t )
+	struct uv_write_t_batch : uv_write_t {
+		List<uv_buf_t> bufs;
+		List<std::pair<void*, size_t>> blocks;		// memory from sendPool( ptr, cap ). free when write finished
+		List<BBuffer_s> shareds;					// hold shared data until write finished
+		size_t len = 0;								// total bytes of bufs
+
+		inline void Clear(UvSendPool& pool) noexcept {
+			for (auto&& b : blocks) {
+				pool.Free(b.first, b.second);
+			}
+			blocks.Clear();
+			bufs.Clear();
+			shareds.Clear();
+			len = 0;
+		}
+	};
+
 	struct UvKcp;
+	struct UvPeerBase;
 	struct Uv {
 		uv_loop_t uvLoop;
 		BBuffer recvBB;								// shared deserialization for package receive. direct replace buf when using
@@ -14,11 +310,34 @@ namespace xx {
 		Dict<int, std::weak_ptr<UvKcp>> udps;		// key: port( dialer peer port = autoId )
 		char* recvBuf = nullptr;					// shared receive buf for kcp
 		size_t recvBufLen = 65535;					// shared receive buf's len
+		char* readBuf = nullptr;					// shared buf for tcp read & udp recv( AllocCB )
+		size_t readBufLen = 65536;					// shared read buf's len
 		uv_run_mode runMode = UV_RUN_DEFAULT;		// reduce frame client update kcp delay
+		UvTimeWheel wheel;							// shared timer for peers, kcp listeners & dialers
+		UvSendPool sendPool;						// tcp send request + data memory cache
+		List<uv_write_t_batch*> writeBatchs;		// recycled tcp write requests
+		List<std::shared_ptr<UvPeerBase>> flushPeers;	// peers has pending writes. Flush at prepare stage( before poll )
+		List<std::shared_ptr<UvPeerBase>> flushingPeers;	// swap with flushPeers when flushing
+		uv_prepare_t flusher;
+#if XX_UV_MMSG
+		static constexpr int mmsgCap = 64;			// max datagrams per recvmmsg / sendmmsg
+		static constexpr int mmsgBufLen = 2048;		// recv slot's len( > kcp mtu. longer datagram will be ignored )
+		struct MMsgRecv {
+			mmsghdr hdrs[mmsgCap];
+			iovec iovs[mmsgCap];
+			sockaddr_in6 addrs[mmsgCap];
+			char bufs[mmsgCap][mmsgBufLen];
+		};
+		std::unique_ptr<MMsgRecv> mmsgRecv;			// shared recv slots for kcp. create when first use
+#endif
 
 		Uv() {
 			if (int r = uv_loop_init(&uvLoop)) throw r;
+			if (int r = wheel.Init(&uvLoop)) throw r;
+			if (int r = uv_prepare_init(&uvLoop, &flusher)) throw r;
+			uvLoop.data = this;						// for AllocCB
 			recvBuf = new char[recvBufLen];
+			readBuf = new char[readBufLen];
 		}
 		Uv(Uv const&) = delete;
 		Uv& operator=(Uv const&) = delete;
@@ -29,11 +348,55 @@ namespace xx {
 				delete[] recvBuf;
 				recvBuf = nullptr;
 			}
+			if (readBuf) {
+				delete[] readBuf;
+				readBuf = nullptr;
+			}
+			flushPeers.Clear();
+			flushingPeers.Clear();
+			uv_close((uv_handle_t*)& flusher, nullptr);
+			wheel.Close();
 
 			int r = uv_run(&uvLoop, UV_RUN_DEFAULT);
 			assert(!r);
 			r = uv_loop_close(&uvLoop);
 			assert(!r);
+			for (auto&& b : writeBatchs) {
+				b->Clear(sendPool);
+				delete b;
+			}
+		}
+
+		inline uv_write_t_batch* PopWriteBatch() noexcept {
+			if (writeBatchs.len) {
+				auto b = writeBatchs.Top();
+				writeBatchs.Pop();
+				return b;
+			}
+			return new (std::nothrow) uv_write_t_batch();
+		}
+
+		inline void PushWriteBatch(uv_write_t_batch* const& b) noexcept {
+			b->Clear(sendPool);
+			if (writeBatchs.len < 256) {
+				writeBatchs.Add(b);
+			}
+			else {
+				delete b;
+			}
+		}
+
+		// call peer->Flush() at prepare stage of this loop iteration
+		void DelayFlush(std::shared_ptr<UvPeerBase>&& peer) noexcept;
+
+		// make sure sendBB's buf is not empty( take from sendPool ). for send package serialize
+		inline int PrepareSendBB() noexcept {
+			if (sendBB.buf) return 0;
+			size_t cap = 1024;
+			sendBB.buf = (uint8_t*)sendPool.Alloc(cap);
+			if (!sendBB.buf) return -1;
+			sendBB.cap = cap;
+			return 0;
 		}
 
 		int Run(uv_run_mode const& mode = UV_RUN_DEFAULT) noexcept {
@@ -69,9 +432,24 @@ namespace xx {
 				Uv::Free(handle);
 				});
 		}
-		inline static void AllocCB(uv_handle_t * h, size_t suggested_size, uv_buf_t * buf) noexcept {
-			buf->base = (char*)::malloc(suggested_size);
-			buf->len = decltype(uv_buf_t::len)(suggested_size);
+		// 为已创建 socket 的 tcp / udp handle 开启 SO_REUSEPORT( 多个 loop 可 bind 同一端口, 由内核分摊连接 / 数据报 ). 须于 bind 前调用
+		inline static int SetReusePort(uv_handle_t * const& h) noexcept {
+#ifdef SO_REUSEPORT
+			uv_os_fd_t fd;
+			if (int r = uv_fileno(h, &fd)) return r;
+			int on = 1;
+			if (setsockopt((int)fd, SOL_SOCKET, SO_REUSEPORT, (char const*)& on, sizeof(on))) return -errno;
+			return 0;
+#else
+			return UV_ENOTSUP;
+#endif
+		}
+
+		// all tcp read & udp recv use uv.readBuf: data is handled( or copied ) in read callback, no overlap. no need malloc / free every time
+		inline static void AllocCB(uv_handle_t * h, size_t, uv_buf_t * buf) noexcept {
+			auto&& uv = *(Uv*)h->loop->data;
+			buf->base = uv.readBuf;
+			buf->len = decltype(uv_buf_t::len)(uv.readBufLen);
 		}
 
 		inline static int FillIP(sockaddr_in6 & saddr, std::string & ip, bool includePort = true) noexcept {
@@ -130,12 +508,27 @@ namespace xx {
 	using UvItem_s = std::shared_ptr<UvItem>;
 	using UvItem_w = std::weak_ptr<UvItem>;
 
+	// 跨线程投递函数到 uv 线程执行. Dispatch 可于任意线程调用( 无锁, 多生产者 ), 每次唤醒执行完所有已入队的函数
 	struct UvAsync : UvItem {
+		using Action = kapala::fixed_function<void()>;
 		uv_async_t* uvAsync = nullptr;
-		std::mutex mtx;
-		std::deque<std::function<void()>> actions;
-		std::function<void()> action;	// for pop store
 
+	protected:
+		// 无锁 多生产者 单消费者 队列( Vyukov intrusive MPSC ). head 为已执行过的哨兵节点, head->next 为首个待执行节点
+		struct Node {
+			std::atomic<Node*> next{ nullptr };
+			Action action;
+		};
+		Node stub;
+		Node* head = &stub;
+		std::atomic<Node*> tail{ &stub };
+
+		// Dispatch 与 Dispose 的同步: 生产者先登记 dispatching 再检查 closed; Dispose 先置 closed 再等 dispatching 归 0 才关闭句柄
+		// 故生产者要么看到 closed 直接返回, 要么 Dispose 会等它 入队 & 链接 & uv_async_send 完毕. 句柄不会在使用中被释放, 也不会有节点漏链
+		std::atomic<bool> closed{ false };
+		std::atomic<int> dispatching{ 0 };
+
+	public:
 		UvAsync(Uv& uv)
 			: UvItem(uv) {
 			uvAsync = Uv::Alloc<uv_async_t>(this);
@@ -149,41 +542,158 @@ namespace xx {
 		}
 		UvAsync(UvAsync const&) = delete;
 		UvAsync& operator=(UvAsync const&) = delete;
-		~UvAsync() { this->Dispose(0); }
+		~UvAsync() {
+			this->Dispose(0);
+			Clear();
+			if (head != &stub) {
+				delete head;
+			}
+		}
 
+		// 只于 uv 线程调用. 其他线程以 Dispatch 的返回值判断
 		inline virtual bool Disposed() const noexcept override {
 			return !uvAsync;
 		}
+		// 只于 uv 线程调用. 会等待正在进行中的 Dispatch 结束( 很短: 入队 + uv_async_send )
 		inline virtual void Dispose(int const& flag = 1) noexcept override {
 			if (!uvAsync) return;
+			closed.store(true);
+			while (dispatching.load()) {
+				std::this_thread::yield();
+			}
 			Uv::HandleCloseAndFree(uvAsync);
 			if (flag) {
 				auto holder = shared_from_this();
-				actions.clear();
+				Clear();
 			}
 		}
-		inline int Dispatch(std::function<void()>&& action) noexcept {
-			if (!uvAsync) return -1;
-			{
-				std::scoped_lock<std::mutex> g(mtx);
-				actions.push_back(std::move(action));
+
+		// 可于任意线程调用. 多次 Dispatch 可能只触发一次唤醒, 唤醒时按入队顺序执行完所有函数. 已 Dispose 返回 -1
+		inline int Dispatch(Action&& action) noexcept {
+			dispatching.fetch_add(1);
+			if (closed.load()) {
+				dispatching.fetch_sub(1);
+				return -1;
 			}
-			return uv_async_send(uvAsync);
+			auto n = new (std::nothrow) Node();
+			if (!n) {
+				dispatching.fetch_sub(1);
+				return -2;
+			}
+			n->action = std::move(action);
+			auto prev = tail.exchange(n, std::memory_order_acq_rel);
+			prev->next.store(n, std::memory_order_release);
+			auto r = uv_async_send(uvAsync);
+			dispatching.fetch_sub(1);
+			return r;
 		}
 
 	protected:
+		// 弹出一个函数. 队列空( 或生产者 exchange 后尚未链接, 其随后的 uv_async_send 会再次唤醒 ) 返回 false
+		inline bool Pop(Action& action) noexcept {
+			auto next = head->next.load(std::memory_order_acquire);
+			if (!next) return false;
+			action = std::move(next->action);
+			if (head != &stub) {
+				delete head;
+			}
+			head = next;
+			return true;
+		}
+
+		// 丢弃所有待执行函数( 只于 uv 线程调用 )
+		inline void Clear() noexcept {
+			Action action;
+			while (Pop(action)) {
+				action = nullptr;
+			}
+		}
+
 		inline void Execute() noexcept {
-			{
-				std::scoped_lock<std::mutex> g(mtx);
-				action = std::move(actions.front());
-				actions.pop_front();
+			Action action;
+			while (Pop(action)) {
+				action();
+				if (!uvAsync) break;		// 被 action Dispose
 			}
-			action();
 		}
 	};
 	using UvAsync_s = std::shared_ptr<UvAsync>;
 	using UvAsync_w = std::weak_ptr<UvAsync>;
 
+	// 多 loop 组: N 个 Uv 各自跑在独立线程上. 配合 UvListener 的 reusePort 监听同一端口, 由内核将连接 / 数据报分摊到各 loop
+	// 每个 Uv 自带 recvBB, sendBB, recvBuf, sendPool, wheel. 挂在某 loop 上的对象( peer, 场景... )只能于该 loop 线程访问
+	// 跨 loop 通信: Dispatch 投递函数到目标 loop 线程执行
+	struct UvGroup {
+		std::vector<std::unique_ptr<Uv>> uvs;
+		std::vector<UvAsync_s> asyncs;				// 与 uvs 一一对应. 跨线程投递入口( 同时令 loop 在无别的 handle 时保持运行 )
+		std::vector<std::thread> threads;
+
+		// numLoops <= 0: 取 cpu 核数
+		explicit UvGroup(int const& numLoops = 0) {
+			int n = numLoops > 0 ? numLoops : (int)std::thread::hardware_concurrency();
+			if (n < 1) n = 1;
+			for (int i = 0; i < n; ++i) {
+				uvs.emplace_back(std::make_unique<Uv>());
+				asyncs.emplace_back(Make<UvAsync>(*uvs.back()));
+			}
+		}
+		UvGroup(UvGroup const&) = delete;
+		UvGroup& operator=(UvGroup const&) = delete;
+		~UvGroup() {
+			Stop();
+			Join();
+			asyncs.clear();							// 先于 uvs 析构( ~Uv 会 run 到所有 handle 关闭 )
+			uvs.clear();
+		}
+
+		inline int Size() const noexcept {
+			return (int)uvs.size();
+		}
+
+		// 为每个 loop 起线程: 先于该线程执行 init( uv, loop 下标 ), 返回 0 则 Run, 非 0 则线程直接退出
+		// Run 结束( Stop )后于该线程执行 cleanup( 释放 init 创建的对象 ). 重复调用返回 -1
+		inline int Start(std::function<int(Uv& uv, int const& index)>&& init, std::function<void(Uv& uv, int const& index)>&& cleanup = nullptr) {
+			if (threads.size()) return -1;
+			auto&& fi = std::make_shared<std::function<int(Uv& uv, int const& index)>>(std::move(init));
+			auto&& fc = std::make_shared<std::function<void(Uv& uv, int const& index)>>(std::move(cleanup));
+			for (int i = 0; i < Size(); ++i) {
+				threads.emplace_back([this, i, fi, fc] {
+					auto&& uv = *uvs[i];
+					if (*fi && (*fi)(uv, i)) return;
+					uv.Run();
+					if (*fc) {
+						(*fc)(uv, i);
+					}
+				});
+			}
+			return 0;
+		}
+
+		// 可于任意线程调用: 投递函数到第 index 个 loop 的线程执行
+		inline int Dispatch(int const& index, UvAsync::Action&& action) noexcept {
+			assert(index >= 0 && index < Size());
+			return asyncs[index]->Dispatch(std::move(action));
+		}
+
+		// 可于任意线程调用: 通知所有 loop 退出 Run
+		inline void Stop() noexcept {
+			for (int i = 0; i < Size(); ++i) {
+				auto uv = uvs[i].get();
+				Dispatch(i, [uv] { uv->Stop(); });
+			}
+		}
+
+		// 等待所有 loop 线程退出. 不可于 loop 线程中调用
+		inline void Join() noexcept {
+			for (auto&& t : threads) {
+				if (t.joinable()) {
+					t.join();
+				}
+			}
+			threads.clear();
+		}
+	};
+
 	struct UvTimer : UvItem {
 		uv_timer_t* uvTimer = nullptr;
 		uint64_t timeoutMS = 0;
@@ -374,17 +884,24 @@ namespace xx {
 	struct UvPeerBase : UvItem {
 		using UvItem::UvItem;
 		UvPeer* peer = nullptr;
+		Buffer buf;									// trailing partial package( header + data ) of last Unpack
+		uint32_t maxPackageLength = 16 * 1024 * 1024;	// max package len( exclude header ). longer: Unpack fail. fill by creater
 		virtual std::string GetIP() noexcept = 0;
 		virtual int SendPackage(Object_s const& data, int32_t const& serial = 0) noexcept = 0;
 		virtual int SendPackage(BBuffer const& data, int32_t const& serial = 0) noexcept = 0;		// for lua
+		virtual int SendSharedPackage(BBuffer_s const& data, int32_t const& serial = 0) noexcept = 0;	// data: WriteRoot result. can share for many peers
 		virtual void Flush() noexcept = 0;
 		virtual int Update(int64_t const& nowMS) noexcept = 0;
 		virtual bool IsKcp() noexcept = 0;
+
+		// 4 bytes len header. can override for custom header format.
+		virtual int Unpack(uint8_t * const& recvBuf, uint32_t const& recvLen) noexcept;
 	};
 	using UvPeerBase_s = std::shared_ptr<UvPeerBase>;
 
 	struct UvCreateAcceptBase : UvItem {
 		using UvItem::UvItem;
+		uint32_t maxPackageLength = 16 * 1024 * 1024;	// copy to peerBase when accept
 		std::function<UvPeer_s(Uv& uv)> onCreatePeer;
 		std::function<void(UvPeer_s peer)> onAccept;
 
@@ -398,7 +915,8 @@ namespace xx {
 		std::shared_ptr<UvTcpListener> tcpListener;
 		std::shared_ptr<UvKcpListener> kcpListener;
 
-		UvListener(Uv& uv, std::string const& ip, int const& port, int const& tcpKcpOpt = 2);
+		// reusePort: 开启 SO_REUSEPORT, 以便 UvGroup 的多个 loop 监听同一端口
+		UvListener(Uv& uv, std::string const& ip, int const& port, int const& tcpKcpOpt = 2, bool const& reusePort = false);
 		~UvListener() {
 			Dispose(0);
 		}
@@ -437,17 +955,27 @@ namespace xx {
 		Dict<int, std::pair<std::function<int(Object_s&& msg)>, int64_t>> callbacks;
 		int serial = 0;
 		int64_t timeoutMS = 0;
-		UvTimer_s timer;
+		UvWheelNode updater;		// link to uv.wheel when timeoutMS or callbacks exists
+		int64_t updateMS = 0;		// updater's deadline
 		std::function<void()> onDisconnect;
+		// tcp send backlog protection. when libuv write queue + pending bytes > sendHighWater( 0: no limit ), sendOverflowPolicy:
+		// 0: drop the package( send return -3 )  1: disconnect  2: keep send & onSendOverflow(true) for pause producer. onSendOverflow(false) when backlog < half
+		size_t sendHighWater = 0;
+		int sendOverflowPolicy = 0;
+		std::function<void(bool const& paused)> onSendOverflow;
 		std::function<int(Object_s&& msg)> onReceivePush;
 		std::function<int(int const& serial, Object_s&& msg)> onReceiveRequest;
 		std::string ip;			// cache
 
 		UvPeer(Uv& uv)
 			: UvItem(uv) {
-			MakeTo(timer, uv, 10, 10, [this] {
+			updater.onTimeout = [this] {
+				auto holder = shared_from_this();	// hold for callback Dispose
 				Update(NowSteadyEpochMS());
-				});
+				if (!Disposed()) {
+					ScheduleUpdate(NextUpdateMS());
+				}
+			};
 		}
 
 		inline std::string GetIP() noexcept {
@@ -462,6 +990,27 @@ namespace xx {
 
 		inline void ResetTimeoutMS(int64_t const& ms) noexcept {
 			timeoutMS = ms ? NowSteadyEpochMS() + ms : 0;
+			if (timeoutMS) {
+				ScheduleUpdate(timeoutMS);
+			}
+		}
+
+		// link updater to wheel if deadline earlier than current. ms < 0: ignore
+		inline void ScheduleUpdate(int64_t const& ms) noexcept {
+			if (ms < 0 || (updater.Linked() && updateMS <= ms)) return;
+			updateMS = ms;
+			uv.wheel.Add(&updater, ms);
+		}
+
+		// min deadline of timeoutMS & callbacks. -1: none
+		inline virtual int64_t NextUpdateMS() noexcept {
+			int64_t ms = timeoutMS ? timeoutMS : -1;
+			for (auto&& kv : callbacks) {
+				if (ms < 0 || kv.value.second < ms) {
+					ms = kv.value.second;
+				}
+			}
+			return ms;
 		}
 
 		inline void Flush() noexcept {
@@ -486,10 +1035,28 @@ namespace xx {
 			return peerBase->SendPackage(data);
 		}
 
+		// data: pre serialized package ( WriteRoot result )
+		inline int SendPush(BBuffer const& data) noexcept {
+			return peerBase->SendPackage(data);
+		}
+
 		inline int SendResponse(int32_t const& serial, Object_s const& data) noexcept {
 			return peerBase->SendPackage(data, serial);
 		}
 
+		// data: pre serialized package ( MakeSharedPackage ). send to many peers without copy
+		inline int SendSharedPush(BBuffer_s const& data) noexcept {
+			return peerBase->SendSharedPackage(data);
+		}
+
+		// serialize once for broadcast( SendSharedPush to N peers )
+		inline static BBuffer_s MakeSharedPackage(Object_s const& data) noexcept {
+			auto&& bb = TryMake<BBuffer>();
+			if (!bb) return bb;
+			bb->WriteRoot(data);
+			return bb;
+		}
+
 		inline int SendRequest(Object_s const& data, std::function<int(Object_s&& msg)>&& cb, uint64_t const& timeoutMS) noexcept {
 			if (!peerBase) return -1;
 			std::pair<std::function<int(Object_s && msg)>, int64_t> v;
@@ -498,6 +1065,7 @@ namespace xx {
 				v.second = NowSteadyEpochMS() + timeoutMS;
 			}
 			if (int r = peerBase->SendPackage(data, -serial)) return r;
+			ScheduleUpdate(v.second);
 			v.first = std::move(cb);
 			callbacks[serial] = std::move(v);
 			return 0;
@@ -533,7 +1101,7 @@ namespace xx {
 			}
 		}
 
-		// call by timer
+		// call by uv.wheel
 		inline virtual int Update(int64_t const& nowMS) noexcept {
 			assert(peerBase);
 			if (timeoutMS && timeoutMS < nowMS) {
@@ -562,7 +1130,7 @@ namespace xx {
 		inline virtual void Dispose(int const& flag = 1) noexcept override {
 			if (!peerBase) return;
 			peerBase.reset();
-			timer.reset();
+			updater.Unlink();
 			for (auto&& kv : callbacks) {
 				kv.value.first(nullptr);
 			}
@@ -588,22 +1156,83 @@ namespace xx {
 		}
 	}
 
+	// complete packages are parsed in place from recvBuf. only the trailing partial package stage to buf( no memmove )
+	inline int UvPeerBase::Unpack(uint8_t * const& recvBuf, uint32_t const& recvLen) noexcept {
+		auto data = recvBuf;
+		size_t dataLen = recvLen;
+
+		// fill the remain package first
+		if (buf.len) {
+			if (buf.len < 4) {
+				auto n = (std::min)(4 - buf.len, dataLen);
+				buf.AddRange(data, n);
+				data += n;
+				dataLen -= n;
+				if (buf.len < 4) return 0;
+			}
+			uint32_t len = buf[0] + (buf[1] << 8) + (buf[2] << 16) + (buf[3] << 24);
+			if (!len || len > maxPackageLength) return -1;		// invalid length
+			auto n = (std::min)(4 + len - buf.len, dataLen);
+			buf.AddRange(data, n);
+			data += n;
+			dataLen -= n;
+			if (buf.len < 4 + len) return 0;					// not enough data
+			if (int r = peer->HandlePack(buf.buf + 4, len)) return r;
+			buf.Clear(buf.cap > 65536);							// release big package's memory
+		}
+
+		size_t offset = 0;
+		while (offset + 4 <= dataLen) {							// ensure header len( 4 bytes )
+			uint32_t len = data[offset + 0] + (data[offset + 1] << 8) + (data[offset + 2] << 16) + (data[offset + 3] << 24);
+			if (!len || len > maxPackageLength) return -1;		// invalid length
+			if (offset + 4 + len > dataLen) break;				// not enough data
+
+			offset += 4;
+			if (int r = peer->HandlePack(data + offset, len)) return r;
+			offset += len;
+		}
+		if (offset < dataLen) {
+			buf.AddRange(data + offset, dataLen - offset);
+		}
+		return 0;
+	}
+
+	inline void Uv::DelayFlush(std::shared_ptr<UvPeerBase>&& peer) noexcept {
+		flushPeers.Add(std::move(peer));
+		if (flushPeers.len > 1) return;
+		uv_prepare_start(&flusher, [](uv_prepare_t* h) {
+			auto&& self = (Uv*)h->loop->data;
+			self->flushingPeers = std::move(self->flushPeers);	// swap. Flush may add new one
+			for (auto&& p : self->flushingPeers) {
+				p->Flush();
+			}
+			self->flushingPeers.Clear();
+			if (!self->flushPeers.len) {
+				uv_prepare_stop(h);
+			}
+		});
+	}
+
 	inline void UvListenerBase::Accept(UvPeerBase_s pb) noexcept {
 		assert(pb);
 		auto&& p = listener->CreatePeer();
 		p->peerBase = pb;
 		pb->peer = &*p;
+		pb->maxPackageLength = listener->maxPackageLength;
 		listener->Accept(p);
 	}
 
+	// package memory block( from uv.sendPool ) header. only buf & cap are used when append to uv_write_t_batch
 	struct uv_write_t_ex : uv_write_t {
 		uv_buf_t buf;
+		size_t cap;								// memory size for sendPool.Free
 	};
 
 	struct UvTcpPeerBase : UvPeerBase {
 		uv_tcp_t* uvTcp = nullptr;
 		std::string ip;
-		Buffer buf;
+		uv_write_t_batch* batch = nullptr;			// pending writes. Flush at uv's prepare stage or manual call
+		bool sendPaused = false;					// backlog over high water( policy 2 )
 
 		UvTcpPeerBase(Uv& uv) : UvPeerBase(uv) {
 			uvTcp = Uv::Alloc<uv_tcp_t>(this);
@@ -616,6 +1245,10 @@ namespace xx {
 
 		inline virtual void Dispose(int const& flag = 1) noexcept override {
 			if (!uvTcp) return;
+			if (batch) {
+				uv.PushWriteBatch(batch);
+				batch = nullptr;
+			}
 			Uv::HandleCloseAndFree(uvTcp);
 			if (flag) {
 				peer->Dispose(flag);
@@ -644,7 +1277,7 @@ namespace xx {
 			if (!uvTcp) return -1;
 			auto& sendBB = uv.sendBB;
 			static_assert(sizeof(uv_write_t_ex) + 4 <= 1024);
-			sendBB.Reserve(1024);
+			if (uv.PrepareSendBB()) return -2;
 			sendBB.len = sizeof(uv_write_t_ex) + 4;		// skip uv_write_t_ex + header space
 			sendBB.Write(serial);
 			if constexpr (std::is_same_v<BBuffer, Data>) {
@@ -653,12 +1286,13 @@ namespace xx {
 			else {
 				sendBB.WriteRoot(data);
 			}
-			auto buf = sendBB.buf;						// cut buf memory for send
+			auto buf = sendBB.buf;						// cut buf memory for send. will be recycle to uv.sendPool
 			auto len = sendBB.len - sizeof(uv_write_t_ex) - 4;
+			auto cap = sendBB.cap;
 			sendBB.buf = nullptr;
 			sendBB.len = 0;
 			sendBB.cap = 0;
-			return SendReqAndData(buf, (uint32_t)len);
+			return SendReqAndData(buf, (uint32_t)len, cap);
 		}
 
 		inline virtual int SendPackage(Object_s const& data, int32_t const& serial = 0) noexcept override {
@@ -668,7 +1302,54 @@ namespace xx {
 			return SendPackageCore(data, serial);
 		}
 
-		inline virtual void Flush() noexcept override {}
+		// scatter / gather: header in sendPool memory, shared data no copy( hold until write finished )
+		inline virtual int SendSharedPackage(BBuffer_s const& data, int32_t const& serial = 0) noexcept override {
+			if (!uvTcp) return -1;
+			assert(data && data->len);
+			if (int r = CheckSendBacklog(4 + 5 + data->len)) return r;
+			size_t cap = 4 + 5;									// 5: serial's max var length
+			auto&& header = (uint8_t*)uv.sendPool.Alloc(cap);
+			if (!header) return -2;
+			BBuffer bb;
+			bb.Reset(header, 4, 4 + 5);
+			bb.Write(serial);
+			auto headerLen = bb.len;
+			bb.Reset();
+			auto len = uint32_t(headerLen - 4 + data->len);
+			header[0] = uint8_t(len);							// fill package len
+			header[1] = uint8_t(len >> 8);
+			header[2] = uint8_t(len >> 16);
+			header[3] = uint8_t(len >> 24);
+
+			if (int r = PrepareBatch()) {
+				uv.sendPool.Free(header, cap);
+				return r;
+			}
+			batch->bufs.Add(uv_buf_init((char*)header, (unsigned int)headerLen), uv_buf_init((char*)data->buf, (unsigned int)data->len));
+			batch->blocks.Add(std::make_pair((void*)header, cap));
+			batch->shareds.Add(data);
+			batch->len += headerLen + data->len;
+			return 0;
+		}
+
+		// write all pending packages by one uv_write
+		inline virtual void Flush() noexcept override {
+			if (!uvTcp || !batch) return;
+			auto b = batch;
+			batch = nullptr;
+			int r = uv_write(b, (uv_stream_t*)uvTcp, b->bufs.buf, (unsigned int)b->bufs.len, [](uv_write_t * req, int status) {
+				auto h = req->handle;
+				((Uv*)h->loop->data)->PushWriteBatch((uv_write_t_batch*)req);
+				if (!status && !uv_is_closing((uv_handle_t*)h)) {
+					Uv::GetSelf<UvTcpPeerBase>(h)->CheckSendResume();
+				}
+				});
+			if (r) {
+				uv.PushWriteBatch(b);
+				auto holder = shared_from_this();
+				Dispose(1);
+			}
+		}
 
 		inline virtual int Update(int64_t const& nowMS) noexcept override { return 0; }
 
@@ -682,7 +1363,6 @@ namespace xx {
 				if (nread > 0) {
 					nread = self->Unpack((uint8_t*)buf->base, (uint32_t)nread);
 				}
-				if (buf) ::free(buf->base);
 				if (nread < 0) {
 					if (!self->Disposed()) {
 						self->Dispose(1);
@@ -692,46 +1372,86 @@ namespace xx {
 		}
 
 		// 4 byte len header. can override for write custom header format
-		virtual int Unpack(uint8_t * const& recvBuf, uint32_t const& recvLen) noexcept {
-			buf.AddRange(recvBuf, recvLen);
-			size_t offset = 0;
-			while (offset + 4 <= buf.len) {							// ensure header len( 4 bytes )
-				auto len = buf[offset + 0] + (buf[offset + 1] << 8) + (buf[offset + 2] << 16) + (buf[offset + 3] << 24);
-				if (len <= 0 /* || len > maxLimit */) return -1;	// invalid length
-				if (offset + 4 + len > buf.len) break;				// not enough data
-
-				offset += 4;
-				if (int r = peer->HandlePack(buf.buf + offset, len)) return r;
-				offset += len;
-			}
-			buf.RemoveFront(offset);
-			return 0;
-		}
 
 		inline int Send(uint8_t const* const& buf, ssize_t const& dataLen) noexcept {
 			if (!uvTcp) return -1;
-			auto req = (uv_write_t_ex*)::malloc(sizeof(uv_write_t_ex) + dataLen);
+			size_t cap = sizeof(uv_write_t_ex) + dataLen;
+			auto req = (uv_write_t_ex*)uv.sendPool.Alloc(cap);
 			if (!req) return -2;
 			memcpy(req + 1, buf, dataLen);
 			req->buf.base = (char*)(req + 1);
 			req->buf.len = decltype(uv_buf_t::len)(dataLen);
+			req->cap = cap;
 			return SendReq(req);
 		}
 
-		// launch a send request
+		// append req's buf to batch( send at Flush ). req's memory will be recycle to uv.sendPool
 		inline int SendReq(uv_write_t_ex * const& req) noexcept {
 			if (!uvTcp) return -1;
-			// todo: check send queue len ? protect?  uv_stream_get_write_queue_size((uv_stream_t*)uvTcp);
-			int r = uv_write(req, (uv_stream_t*)uvTcp, &req->buf, 1, [](uv_write_t * req, int status) {
-				::free(req);
-				});
-			if (r) Dispose(1);
-			return r;
+			int r = CheckSendBacklog(req->buf.len);
+			if (!r) {
+				r = PrepareBatch();
+			}
+			if (r) {
+				uv.sendPool.Free(req, req->cap);
+				return r;
+			}
+			batch->bufs.Add(req->buf);
+			batch->blocks.Add(std::make_pair((void*)req, req->cap));
+			batch->len += req->buf.len;
+			return 0;
+		}
+
+		// make sure batch is not empty. first package in this loop iteration: register delay flush
+		inline int PrepareBatch() noexcept {
+			if (batch) return 0;
+			batch = uv.PopWriteBatch();
+			if (!batch) return -2;
+			uv.DelayFlush(std::static_pointer_cast<UvPeerBase>(shared_from_this()));
+			return 0;
+		}
+
+		// libuv write queue + pending bytes
+		inline size_t GetSendBacklog() noexcept {
+			return uv_stream_get_write_queue_size((uv_stream_t*)uvTcp) + (batch ? batch->len : 0);
+		}
+
+		// return non 0: don't send( dropped or disconnected )
+		inline int CheckSendBacklog(size_t const& len) noexcept {
+			if (!peer || !peer->sendHighWater) return 0;
+			if (GetSendBacklog() + len <= peer->sendHighWater) return 0;
+			switch (peer->sendOverflowPolicy) {
+			case 0:
+				return -3;
+			case 1: {
+				auto holder = shared_from_this();
+				Dispose(1);
+				return -4;
+			}
+			default:
+				if (!sendPaused) {
+					sendPaused = true;
+					if (peer->onSendOverflow) {
+						peer->onSendOverflow(true);
+					}
+				}
+				return 0;
+			}
+		}
+
+		// called when write finished
+		inline void CheckSendResume() noexcept {
+			if (!sendPaused || !peer) return;
+			if (GetSendBacklog() > peer->sendHighWater / 2) return;
+			sendPaused = false;
+			if (peer->onSendOverflow) {
+				peer->onSendOverflow(false);
+			}
 		}
 
 		// fast mode. req + data 2N1, reduce malloc times.
-		// reqbuf = uv_write_t_ex space + len space + data, len = data's len
-		inline int SendReqAndData(uint8_t * const& reqbuf, uint32_t const& len) {
+		// reqbuf = uv_write_t_ex space + len space + data, len = data's len, cap = reqbuf's memory size
+		inline int SendReqAndData(uint8_t * const& reqbuf, uint32_t const& len, size_t const& cap) {
 			reqbuf[sizeof(uv_write_t_ex) + 0] = uint8_t(len);		// fill package len
 			reqbuf[sizeof(uv_write_t_ex) + 1] = uint8_t(len >> 8);
 			reqbuf[sizeof(uv_write_t_ex) + 2] = uint8_t(len >> 16);
@@ -740,6 +1460,7 @@ namespace xx {
 			auto req = (uv_write_t_ex*)reqbuf;						// fill req args
 			req->buf.base = (char*)(req + 1);
 			req->buf.len = decltype(uv_buf_t::len)(len + 4);
+			req->cap = cap;
 			return SendReq(req);
 		}
 	};
@@ -755,7 +1476,7 @@ namespace xx {
 		int port = 0;								// fill by owner. dict's key. port > 0: listener  < 0: dialer fill by --uv.udpId
 		virtual void Remove(uint32_t const& conv) noexcept = 0;
 
-		UvKcp(Uv& uv, std::string const& ip, int const& port, bool const& isListener)
+		UvKcp(Uv& uv, std::string const& ip, int const& port, bool const& isListener, bool const& reusePort = false)
 			: UvItem(uv) {
 			if (ip.size()) {
 				if (ip.find(':') == std::string::npos) {
@@ -767,27 +1488,40 @@ namespace xx {
 			}
 			uvUdp = Uv::Alloc<uv_udp_t>(this);
 			if (!uvUdp) throw - 2;
-			if (int r = uv_udp_init(&uv.uvLoop, uvUdp)) {
+#if XX_UV_MMSG
+			// 收发不经 libuv, 需要 fd. 有地址则立即按其地址族创建 socket, 否则延迟到首次 Send 时按目标地址族创建( 同 libuv 的惰性 socket )
+			if (int r = uv_udp_init_ex(&uv.uvLoop, uvUdp, ip.size() ? addr.sin6_family : AF_UNSPEC)) {
+#else
+			if (int r = uv_udp_init_ex(&uv.uvLoop, uvUdp, isListener && reusePort ? addr.sin6_family : AF_UNSPEC)) {
+#endif
 				uvUdp = nullptr;
 				throw r;
 			}
 			ScopeGuard sgUdp([this] { Uv::HandleCloseAndFree(uvUdp); });
 			if (isListener) {
+				if (reusePort) {
+					if (int r = Uv::SetReusePort((uv_handle_t*)uvUdp)) throw r;
+				}
 				if (int r = uv_udp_bind(uvUdp, (sockaddr*)& addr, UV_UDP_REUSEADDR)) throw r;
 			}
+#if XX_UV_MMSG
+			if (ip.size()) {
+				if (int r = InitPoll()) throw r;
+			}
+#else
 			if (int r = uv_udp_recv_start(uvUdp, Uv::AllocCB, [](uv_udp_t * handle, ssize_t nread, const uv_buf_t * buf, const struct sockaddr* addr, unsigned flags) {
 				auto self = Uv::GetSelf<UvKcp>(handle);
 				auto holder = self->shared_from_this();	// hold for callback Dispose
 				if (nread > 0) {
 					nread = self->Unpack((uint8_t*)buf->base, (uint32_t)nread, addr);
 				}
-				if (buf) ::free(buf->base);
 				if (nread < 0) {
 					if (!self->Disposed()) {
 						self->Dispose(1);
 					}
 				}
 				})) throw r;
+#endif
 			sgUdp.Cancel();
 		}
 		UvKcp(UvKcp const&) = delete;
@@ -800,23 +1534,224 @@ namespace xx {
 
 		inline virtual void Dispose(int const& flag = 1) noexcept override {
 			if (!uvUdp) return;
+#if XX_UV_MMSG
+			Uv::HandleCloseAndFree(uvPrepare);
+			Uv::HandleCloseAndFree(uvPoll);
+			sendBuf.Clear();
+			sendCount = 0;
+#endif
 			Uv::HandleCloseAndFree(uvUdp);
 		}
 
 		// send target: addr or this->addr
 		inline virtual int Send(uint8_t const* const& buf, ssize_t const& dataLen, sockaddr const* const& addr = nullptr) noexcept {
 			if (!uvUdp) return -1;
+#if XX_UV_MMSG
+			// 攒起来, 于本轮 loop 进入 poll 前( uvPrepare )或攒满时 合并发出
+			// 格式: 数据长度( 4 ) + 地址长度( 4 ) + 地址 + 数据
+			auto&& a = addr ? addr : (sockaddr*)& this->addr;
+			if (!uvPoll) {
+				if (int r = OpenSocket(a->sa_family)) {
+					Dispose(1);
+					return r;
+				}
+			}
+			uint32_t lens[2] = { (uint32_t)dataLen, a->sa_family == AF_INET6 ? (uint32_t)sizeof(sockaddr_in6) : (uint32_t)sizeof(sockaddr_in) };
+			sendBuf.AddRange((uint8_t*)lens, sizeof(lens));
+			sendBuf.AddRange((uint8_t*)a, lens[1]);
+			sendBuf.AddRange(buf, dataLen);
+			if (++sendCount >= Uv::mmsgCap) return FlushSend();
+			if (!uv_is_active((uv_handle_t*)uvPrepare)) {
+				uv_prepare_start(uvPrepare, [](uv_prepare_t * handle) {
+					auto self = Uv::GetSelf<UvKcp>(handle);
+					auto holder = self->shared_from_this();	// hold for callback Dispose
+					self->FlushSend();
+					});
+			}
+			return 0;
+#else
 			auto req = (uv_udp_send_t_ex*)::malloc(sizeof(uv_udp_send_t_ex) + dataLen);
 			if (!req) return -2;
 			memcpy(req + 1, buf, dataLen);
 			req->buf.base = (char*)(req + 1);
 			req->buf.len = decltype(uv_buf_t::len)(dataLen);
 			return Send(req, addr);
+#endif
 		}
 
+		// 立即发出 Send 攒下的报文( 非 mmsg 模式下 Send 即时发送, 无需调用 )
+		// 报文被丢弃( 目标不可达等 )时 返回首个错误码( -errno ), 并累计到 numSendErrors / lastSendError
+		inline int FlushSend() noexcept {
+#if XX_UV_MMSG
+			if (!uvUdp) return -1;
+			if (!uvPoll) return 0;
+			uv_prepare_stop(uvPrepare);
+			if (!sendCount) return 0;
+			int err = 0;
+			uv_os_fd_t fd;
+			if (int r = uv_fileno((uv_handle_t*)uvUdp, &fd)) return r;
+			mmsghdr hdrs[Uv::mmsgCap];
+			iovec iovs[Uv::mmsgCap];
+			size_t offset = 0;										// 已发出部分的长度
+			while (sendCount) {
+				int n = 0;
+				for (size_t o = offset; n < Uv::mmsgCap && n < sendCount; ++n) {
+					uint32_t lens[2];
+					memcpy(lens, sendBuf.buf + o, sizeof(lens));
+					o += sizeof(lens);
+					auto&& h = hdrs[n].msg_hdr;
+					memset(&h, 0, sizeof(h));
+					h.msg_name = sendBuf.buf + o;
+					h.msg_namelen = lens[1];
+					o += lens[1];
+					iovs[n].iov_base = sendBuf.buf + o;
+					iovs[n].iov_len = lens[0];
+					o += lens[0];
+					h.msg_iov = &iovs[n];
+					h.msg_iovlen = 1;
+				}
+				int r = sendmmsg((int)fd, hdrs, n, MSG_DONTWAIT);
+				if (r < 0) {
+					if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) break;	// 缓冲区满: 等可写再发
+					lastSendError = -errno;							// 别的错误( 例如目标不可达, 地址族不符 ): 丢弃该报文 并记录
+					++numSendErrors;
+					if (!err) {
+						err = lastSendError;
+					}
+					r = 1;
+				}
+				for (int i = 0; i < r; ++i) {
+					offset += sizeof(uint32_t) * 2 + hdrs[i].msg_hdr.msg_namelen + iovs[i].iov_len;
+				}
+				sendCount -= r;
+			}
+			if (sendCount) {
+				sendBuf.RemoveFront(offset);
+			}
+			else {
+				sendBuf.Clear();
+			}
+			// 有剩余则同时监视可写
+			if (waitWritable != (sendCount != 0)) {
+				waitWritable = sendCount != 0;
+				if (int r = uv_poll_start(uvPoll, waitWritable ? (UV_READABLE | UV_WRITABLE) : UV_READABLE, OnPoll)) {
+					Dispose(1);
+					return r;
+				}
+			}
+			return err;
+#else
+			return 0;
+#endif
+		}
+
+#if XX_UV_MMSG
+		uint64_t numSendErrors = 0;					// sendmmsg 丢弃的报文数( 不含 缓冲区满 等待重发 的 )
+		int lastSendError = 0;						// 最后一次 sendmmsg 错误( -errno )
+#endif
+
 	protected:
 		virtual int Unpack(uint8_t * const& recvBuf, uint32_t const& recvLen, sockaddr const* const& addr) noexcept = 0;
 
+#if XX_UV_MMSG
+		uv_poll_t* uvPoll = nullptr;				// watch uvUdp's fd readable / writable
+		uv_prepare_t* uvPrepare = nullptr;			// active when sendBuf not empty. FlushSend before loop poll
+		Buffer sendBuf;								// Send's datagrams( for batch send )
+		int sendCount = 0;							// sendBuf's datagram count
+		bool waitWritable = false;					// is uvPoll watching UV_WRITABLE
+
+		// uvUdp 只用于持有 socket. 可读 / 可写 由 uvPoll 监视, 自己 recvmmsg / sendmmsg. 需 uvUdp 已有 socket
+		inline int InitPoll() noexcept {
+			uv_os_fd_t fd;
+			if (int r = uv_fileno((uv_handle_t*)uvUdp, &fd)) return r;
+			uvPoll = Uv::Alloc<uv_poll_t>(this);
+			if (!uvPoll) return -3;
+			if (int r = uv_poll_init(&uv.uvLoop, uvPoll, fd)) {
+				Uv::Free(uvPoll);
+				uvPoll = nullptr;
+				return r;
+			}
+			ScopeGuard sgPoll([this] { Uv::HandleCloseAndFree(uvPoll); });
+			uvPrepare = Uv::Alloc<uv_prepare_t>(this);
+			if (!uvPrepare) return -4;
+			if (int r = uv_prepare_init(&uv.uvLoop, uvPrepare)) {
+				Uv::Free(uvPrepare);
+				uvPrepare = nullptr;
+				return r;
+			}
+			ScopeGuard sgPrepare([this] { Uv::HandleCloseAndFree(uvPrepare); });
+			if (int r = uv_poll_start(uvPoll, UV_READABLE, OnPoll)) return r;
+			sgPrepare.Cancel();
+			sgPoll.Cancel();
+			return 0;
+		}
+
+		// 首次 Send 时按目标地址族创建 socket 并开始监视( 构造时没有地址的 dialer 用 )
+		inline int OpenSocket(int const& family) noexcept {
+			int s = socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+			if (s < 0) return -errno;
+			if (int r = uv_udp_open(uvUdp, s)) {
+				::close(s);
+				return r;
+			}
+			return InitPoll();
+		}
+
+		inline static void OnPoll(uv_poll_t * handle, int status, int events) noexcept {
+			auto self = Uv::GetSelf<UvKcp>(handle);
+			auto holder = self->shared_from_this();	// hold for callback Dispose
+			if (status < 0) {
+				if (!self->Disposed()) {
+					self->Dispose(1);
+				}
+				return;
+			}
+			if (events & UV_WRITABLE) {
+				self->FlushSend();
+				if (self->Disposed()) return;
+			}
+			if (events & UV_READABLE) {
+				self->RecvMMsg();
+			}
+		}
+
+		// 一次最多收 mmsgCap 个报文. 收满则再收, 限制轮数以免饿死别的 handle
+		inline void RecvMMsg() noexcept {
+			if (!uv.mmsgRecv) {
+				uv.mmsgRecv.reset(new (std::nothrow) Uv::MMsgRecv);
+				if (!uv.mmsgRecv) return;
+			}
+			auto&& m = *uv.mmsgRecv;
+			uv_os_fd_t fd;
+			if (uv_fileno((uv_handle_t*)uvUdp, &fd)) return;
+			for (int round = 0; round < 4; ++round) {
+				for (int i = 0; i < Uv::mmsgCap; ++i) {
+					m.iovs[i].iov_base = m.bufs[i];
+					m.iovs[i].iov_len = Uv::mmsgBufLen;
+					auto&& h = m.hdrs[i].msg_hdr;
+					memset(&h, 0, sizeof(h));
+					h.msg_name = &m.addrs[i];
+					h.msg_namelen = sizeof(sockaddr_in6);
+					h.msg_iov = &m.iovs[i];
+					h.msg_iovlen = 1;
+				}
+				int n = recvmmsg((int)fd, m.hdrs, Uv::mmsgCap, MSG_DONTWAIT, nullptr);
+				if (n <= 0) return;									// EAGAIN or error( icmp ... ): ignore
+				for (int i = 0; i < n; ++i) {
+					auto&& len = m.hdrs[i].msg_len;
+					if (!len || (m.hdrs[i].msg_hdr.msg_flags & MSG_TRUNC)) continue;
+					if (Unpack((uint8_t*)m.bufs[i], len, (sockaddr*)& m.addrs[i]) < 0) {
+						if (!Disposed()) {
+							Dispose(1);
+						}
+					}
+					if (Disposed()) return;
+				}
+				if (n < Uv::mmsgCap) return;
+			}
+		}
+#endif
+
 		// reqbuf = uv_udp_send_t_ex space + len space + data
 		// len = data's len
 		inline int SendReqAndData(uint8_t * const& reqbuf, uint32_t const& len, sockaddr const* const& addr = nullptr) {
@@ -833,24 +1768,47 @@ namespace xx {
 
 		inline int Send(uv_udp_send_t_ex * const& req, sockaddr const* const& addr = nullptr) noexcept {
 			if (!uvUdp) return -1;
+#if XX_UV_MMSG
+			// 不可混用 uv_udp_send( 会令 libuv 监视同一 fd )
+			int r = Send((uint8_t*)req->buf.base, req->buf.len, addr);
+			::free(req);
+			return r;
+#else
 			// todo: check send queue len ? protect?
 			int r = uv_udp_send(req, uvUdp, &req->buf, 1, addr ? addr : (sockaddr*)& this->addr, [](uv_udp_send_t * req, int status) {
 				::free(req);
 				});
 			if (r) Dispose(1);
 			return r;
+#endif
 		}
 	};
 
 	struct UvKcpPeerBase : UvPeerBase {
-		using UvPeerBase::UvPeerBase;
 		std::shared_ptr<UvKcp> udp;					// fill by creater
 		uint32_t conv = 0;							// fill by creater
 		int64_t createMS = 0;						// fill by creater
 		ikcpcb* kcp = nullptr;
 		uint32_t nextUpdateMS = 0;					// for kcp update interval control. reduce cpu usage
-		Buffer buf;
 		sockaddr_in6 addr;							// for Send. fill by owner Unpack
+		UvWheelNode updater;						// link to uv.wheel by ikcp_check result. only due sessions will be update
+		int64_t updateMS = 0;						// updater's deadline
+		bool flushPending = false;					// registered to uv.DelayFlush. clear by Flush
+
+		UvKcpPeerBase(Uv& uv)
+			: UvPeerBase(uv) {
+			updater.onTimeout = [this] {
+				auto holder = shared_from_this();	// hold for callback Dispose
+				Update(NowSteadyEpochMS());
+			};
+		}
+
+		// link updater to wheel if deadline earlier than current
+		inline void ScheduleUpdate(int64_t const& ms) noexcept {
+			if (updater.Linked() && updateMS <= ms) return;
+			updateMS = ms;
+			uv.wheel.Add(&updater, ms);
+		}
 
 		// require: fill udp, conv, createMS, addr
 		inline int InitKcp() {
@@ -868,11 +1826,13 @@ namespace xx {
 				return self->udp->Send((uint8_t*)inBuf, len, (sockaddr*)& self->addr);
 				});
 			sgKcp.Cancel();
+			ScheduleUpdate(NowSteadyEpochMS());
 			return 0;
 		}
 
 		inline virtual void Dispose(int const& flag = 1) noexcept override {
 			if (!kcp) return;
+			updater.Unlink();
 			ikcp_release(kcp);
 			kcp = nullptr;
 			udp->Remove(conv);						// remove self from container
@@ -900,16 +1860,17 @@ namespace xx {
 			return !kcp;
 		}
 
-		// called by ext class
+		// called by updater( when due ) or ext class
 		inline virtual int Update(int64_t const& nowMS) noexcept override {
 			if (!kcp) return -1;
 
 			auto&& currentMS = uint32_t(nowMS - createMS);				// known issue: uint32 limit. connect only alive 50+ days
-			if (uv.runMode == UV_RUN_DEFAULT && nextUpdateMS > currentMS) return 0;						// reduce cpu usage
-			ikcp_update(kcp, currentMS);
-			if (!kcp) return -1;
-			if (uv.runMode == UV_RUN_DEFAULT) {
-				nextUpdateMS = ikcp_check(kcp, currentMS);
+			if (uv.runMode != UV_RUN_DEFAULT || nextUpdateMS <= currentMS) {	// reduce cpu usage
+				ikcp_update(kcp, currentMS);
+				if (!kcp) return -1;
+				if (uv.runMode == UV_RUN_DEFAULT) {
+					nextUpdateMS = ikcp_check(kcp, currentMS);
+				}
 			}
 
 			do {
@@ -920,7 +1881,15 @@ namespace xx {
 					return -1;
 				}
 			} while (true);
+			if (!kcp) return -1;
 
+			if (uv.runMode != UV_RUN_DEFAULT) {
+				ScheduleUpdate(nowMS + 10);
+			}
+			else if (kcp->nsnd_buf || kcp->nsnd_que || kcp->ackcount || kcp->probe) {
+				ScheduleUpdate(createMS + nextUpdateMS);
+			}
+			// else: idle. wait for Input or Send reschedule
 			return 0;
 		}
 
@@ -930,8 +1899,7 @@ namespace xx {
 		inline int SendPackageCore(Data const& data, int32_t const& serial = 0) noexcept {
 			if (!kcp) return -1;
 			auto& sendBB = uv.sendBB;
-			static_assert(sizeof(uv_write_t_ex) + 4 <= 1024);
-			sendBB.Reserve(1024);
+			if (uv.PrepareSendBB()) return -2;
 			sendBB.len = 4;		// skip header space
 			sendBB.Write(serial);
 			if constexpr (std::is_same_v<BBuffer, Data>) {
@@ -956,39 +1924,56 @@ namespace xx {
 			return SendPackageCore(data, serial);
 		}
 
+		// kcp is stream mode: send header & data separately. data will be copy to kcp segments
+		inline virtual int SendSharedPackage(BBuffer_s const& data, int32_t const& serial = 0) noexcept override {
+			if (!kcp) return -1;
+			assert(data && data->len);
+			uint8_t header[4 + 5];								// 5: serial's max var length
+			BBuffer bb;
+			bb.Reset(header, 4, sizeof(header));
+			bb.Write(serial);
+			auto headerLen = bb.len;
+			bb.Reset();
+			auto&& len = uint32_t(headerLen - 4 + data->len);
+			header[0] = uint8_t(len);							// fill package len
+			header[1] = uint8_t(len >> 8);
+			header[2] = uint8_t(len >> 16);
+			header[3] = uint8_t(len >> 24);
+			if (int r = Send(header, headerLen)) return r;
+			return Send(data->buf, data->len);
+		}
+
 		// send data immediately ( no wait for more data combine send )
 		inline virtual void Flush() noexcept override {
+			flushPending = false;
 			if (!kcp) return;
 			ikcp_flush(kcp);
+			if (kcp) {
+				udp->FlushSend();
+			}
 		}
 
-		// called by udp class. put data to kcp when udp receive 
+		// called by udp class. put data to kcp when udp receive. reschedule for ack & recv at next tick
 		inline int Input(uint8_t * const& recvBuf, uint32_t const& recvLen) noexcept {
 			if (!kcp) return -1;
-			return ikcp_input(kcp, (char*)recvBuf, recvLen);
-		}
-
-		// 4 bytes len header. can override for custom header format.
-		inline virtual int Unpack(uint8_t * const& recvBuf, uint32_t const& recvLen) noexcept {
-			buf.AddRange(recvBuf, recvLen);
-			size_t offset = 0;
-			while (offset + 4 <= buf.len) {							// ensure header len( 4 bytes )
-				auto len = buf[offset + 0] + (buf[offset + 1] << 8) + (buf[offset + 2] << 16) + (buf[offset + 3] << 24);
-				if (len <= 0 /* || len > maxLimit */) return -1;	// invalid length
-				if (offset + 4 + len > buf.len) break;				// not enough data
-
-				offset += 4;
-				if (int r = peer->HandlePack(buf.buf + offset, len)) return r;
-				offset += len;
-			}
-			buf.RemoveFront(offset);
+			if (int r = ikcp_input(kcp, (char*)recvBuf, recvLen)) return r;
+			nextUpdateMS = 0;
+			ScheduleUpdate(NowSteadyEpochMS());
 			return 0;
 		}
 
+
 		// push send data to kcp. though ikcp_setoutput func send.
 		inline int Send(uint8_t const* const& buf, ssize_t const& dataLen) noexcept {
 			if (!kcp) return -1;
-			return ikcp_send(kcp, (char*)buf, (int)dataLen);
+			if (int r = ikcp_send(kcp, (char*)buf, (int)dataLen)) return r;
+			nextUpdateMS = 0;										// update at next tick
+			ScheduleUpdate(NowSteadyEpochMS());
+			if (!flushPending) {									// first package in this loop iteration: flush before poll
+				flushPending = true;
+				uv.DelayFlush(std::static_pointer_cast<UvPeerBase>(shared_from_this()));
+			}
+			return 0;
 		}
 	};
 
@@ -999,18 +1984,23 @@ namespace xx {
 		Dict<std::string, std::pair<uint32_t, int64_t>> shakes;	// key: ip:port   value: conv, nowMS
 		uint32_t convId = 0;
 		int handShakeTimeoutMS = 3000;
-		UvTimer_s timer;
+		UvWheelNode updater;
 
-		UvListenerKcp(Uv& uv, std::string const& ip, int const& port, bool const& isListener)
-			: UvKcp(uv, ip, port, isListener) {
-			MakeTo(timer, uv, 10, 10, [this] {
-				this->Update(NowSteadyEpochMS());
-				});
+		UvListenerKcp(Uv& uv, std::string const& ip, int const& port, bool const& isListener, bool const& reusePort = false)
+			: UvKcp(uv, ip, port, isListener, reusePort) {
+			updater.onTimeout = [this] {
+				auto holder = shared_from_this();	// hold for callback Dispose
+				auto&& nowMS = NowSteadyEpochMS();
+				this->uv.wheel.Add(&updater, nowMS + 10);
+				this->Update(nowMS);
+			};
+			uv.wheel.Add(&updater, NowSteadyEpochMS() + 10);
 		}
 
 		inline virtual void Dispose(int const& flag = 1) noexcept override {
 			if (!this->uvUdp) return;
 			this->UvKcp::Dispose(flag);
+			updater.Unlink();
 			for (auto&& kv : peers) {
 				if (auto && peer = kv.value.lock()) {
 					peer->Dispose(flag);
@@ -1024,11 +2014,8 @@ namespace xx {
 			this->Dispose(0);
 		}
 
+		// peers are self scheduled by ikcp_check. only handle shakes timeout here
 		inline virtual void Update(int64_t const& nowMS) noexcept {
-			for (auto&& kv : peers) {
-				assert(kv.value.lock());
-				kv.value.lock()->Update(nowMS);
-			}
 			for (auto&& iter = shakes.begin(); iter != shakes.end(); ++iter) {
 				if (iter->value.second < nowMS) {
 					iter.Remove();
@@ -1100,14 +2087,18 @@ namespace xx {
 		int i = 0;
 		bool connected = false;
 		std::weak_ptr<UvKcpPeerBase> peer_w;
-		UvTimer_s timer;
+		UvWheelNode updater;
 		UvDialerBase* owner = nullptr;			// fill by owner
 
 		UvDialerKcp(Uv& uv, std::string const& ip, int const& port, bool const& isListener)
 			: UvKcp(uv, ip, port, isListener) {
-			MakeTo(timer, uv, 10, 10, [this] {
-				this->Update(NowSteadyEpochMS());
-				});
+			updater.onTimeout = [this] {
+				auto holder = shared_from_this();	// hold for callback Dispose
+				auto&& nowMS = NowSteadyEpochMS();
+				this->uv.wheel.Add(&updater, nowMS + 10);
+				this->Update(nowMS);
+			};
+			uv.wheel.Add(&updater, NowSteadyEpochMS() + 10);
 		}
 		~UvDialerKcp() {
 			this->Dispose(0);
@@ -1116,29 +2107,22 @@ namespace xx {
 		inline virtual void Dispose(int const& flag = 1) noexcept override {
 			if (!this->uvUdp) return;
 			this->UvKcp::Dispose(flag);
+			updater.Unlink();
 			if (auto && peer = peer_w.lock()) {
 				peer->Dispose(flag);
 			}
 			uv.udps.Remove(port);
 		}
 
+		// hand shake only. peer is self scheduled after connected
 		inline virtual void Update(int64_t const& nowMS) noexcept {
-			if (connected) {
-				if (auto && peer = peer_w.lock()) {
-					peer->Update(nowMS);
-				}
-				else {
+			if (connected) return;
+			++i;
+			if ((i & 0xFu) == 0) {		// 每 16 帧发送一次
+				if (int r = Send((uint8_t*)& port, sizeof(port))) {
 					Dispose();
 				}
 			}
-			else {
-				++i;
-				if ((i & 0xFu) == 0) {		// 每 16 帧发送一次
-					if (int r = Send((uint8_t*)& port, sizeof(port))) {
-						Dispose();
-					}
-				}
-			}
 		}
 
 		inline virtual void Remove(uint32_t const& conv) noexcept override {
@@ -1165,6 +2149,7 @@ namespace xx {
 				assert(!r);
 				p->Flush();
 				connected = true;								// set flag
+				updater.Unlink();								// stop hand shake
 				owner->Accept(p);								// cleanup all reqs
 				owner = nullptr;
 				return 0;
@@ -1192,7 +2177,7 @@ namespace xx {
 	struct UvKcpListener : UvListenerBase {
 		std::shared_ptr<UvListenerKcp> udp;
 
-		UvKcpListener(Uv& uv, std::string const& ip, int const& port)
+		UvKcpListener(Uv& uv, std::string const& ip, int const& port, bool const& reusePort = false)
 			: UvListenerBase(uv) {
 			auto&& udps = uv.udps;
 			auto&& idx = udps.Find(port);
@@ -1201,7 +2186,7 @@ namespace xx {
 				if (udp->owner) throw - 1;			// same port listener already exists?
 			}
 			else {
-				MakeTo(udp, uv, ip, port, true);
+				MakeTo(udp, uv, ip, port, true, reusePort);
 				udp->port = port;
 				udp->owner = this;
 				udps[port] = udp;
@@ -1228,21 +2213,25 @@ namespace xx {
 		uv_tcp_t* uvTcp = nullptr;
 		sockaddr_in6 addr;
 
-		UvTcpListener(Uv& uv, std::string const& ip, int const& port, int const& backlog = 128)
+		UvTcpListener(Uv& uv, std::string const& ip, int const& port, int const& backlog = 128, bool const& reusePort = false)
 			: UvListenerBase(uv) {
-			uvTcp = Uv::Alloc<uv_tcp_t>(this);
-			if (!uvTcp) throw - 4;
-			if (int r = uv_tcp_init(&uv.uvLoop, uvTcp)) {
-				uvTcp = nullptr;
-				throw r;
-			}
-
 			if (ip.find(':') == std::string::npos) {
 				if (uv_ip4_addr(ip.c_str(), port, (sockaddr_in*)& addr)) throw - 1;
 			}
 			else {
 				if (uv_ip6_addr(ip.c_str(), port, &addr)) throw - 2;
 			}
+
+			uvTcp = Uv::Alloc<uv_tcp_t>(this);
+			if (!uvTcp) throw - 4;
+			if (int r = uv_tcp_init_ex(&uv.uvLoop, uvTcp, reusePort ? addr.sin6_family : AF_UNSPEC)) {
+				uvTcp = nullptr;
+				throw r;
+			}
+			ScopeGuard sgTcp([this] { Uv::HandleCloseAndFree(uvTcp); });
+			if (reusePort) {
+				if (int r = Uv::SetReusePort((uv_handle_t*)uvTcp)) throw r;
+			}
 			if (uv_tcp_bind(uvTcp, (sockaddr*)& addr, 0)) throw - 3;
 
 			if (uv_listen((uv_stream_t*)uvTcp, backlog, [](uv_stream_t * server, int status) {
@@ -1255,6 +2244,7 @@ namespace xx {
 				Uv::FillIP(peer->uvTcp, peer->ip);
 				self->Accept(peer);
 			})) throw - 4;
+			sgTcp.Cancel();
 		};
 
 		UvTcpListener(UvTcpListener const&) = delete;
@@ -1274,14 +2264,14 @@ namespace xx {
 		}
 	};
 
-	inline UvListener::UvListener(Uv& uv, std::string const& ip, int const& port, int const& tcpKcpOpt)
+	inline UvListener::UvListener(Uv& uv, std::string const& ip, int const& port, int const& tcpKcpOpt, bool const& reusePort)
 		: UvCreateAcceptBase(uv) {
 		if (tcpKcpOpt == 0 || tcpKcpOpt == 2) {
-			xx::MakeTo(tcpListener, uv, ip, port);
+			xx::MakeTo(tcpListener, uv, ip, port, 128, reusePort);
 			tcpListener->listener = this;
 		}
 		if (tcpKcpOpt == 1 || tcpKcpOpt == 2) {
-			xx::MakeTo(kcpListener, uv, ip, port);
+			xx::MakeTo(kcpListener, uv, ip, port, reusePort);
 			kcpListener->listener = this;
 		}
 	}
@@ -1352,6 +2342,7 @@ namespace xx {
 		if (!p) return;
 		p->peerBase = pb;
 		pb->peer = &*p;
+		pb->maxPackageLength = dialer->maxPackageLength;
 		dialer->Cancel();
 		dialer->Accept(p);
 	}
@@ -24,6 +24,7 @@ namespace xx {
 				v.second = NowSteadyEpochMS() + timeoutMS;
 			}
 			if (int r = peerBase->SendPackage(data, -serial)) return r;
+			ScheduleUpdate(v.second);
 			v.first = std::move(cb);
 			callbacks[serial] = std::move(v);
 			return 0;
@@ -32,7 +33,7 @@ namespace xx {
 		inline virtual void Dispose(int const& flag = 1) noexcept override {
 			if (!peerBase) return;
 			peerBase.reset();
-			timer.reset();
+			updater.Unlink();
 			for (auto&& kv : callbacks) {
 				kv.value.first(nullptr);
 			}
@@ -72,6 +73,16 @@ namespace xx {
 
 		// 因为重新定义了新的 callbacks 类型 所以需要
 		// 代码直接从基类复制不修改. 
+		inline virtual int64_t NextUpdateMS() noexcept override {
+			int64_t ms = timeoutMS ? timeoutMS : -1;
+			for (auto&& kv : callbacks) {
+				if (ms < 0 || kv.value.second < ms) {
+					ms = kv.value.second;
+				}
+			}
+			return ms;
+		}
+
 		inline virtual int Update(int64_t const& nowMS) noexcept override {
 			assert(peerBase);
 			if (timeoutMS && timeoutMS < nowMS) {